@@ -0,0 +1,407 @@
+/**
+ *  @file benchmark.cpp
+ *  @brief  Benchmarks of every generator in generator.h.
+ *
+ * Each generator is run for \f$n = 10^3, 10^4, \dots\f$ up to its own limit
+ * and `--max-n`, each size in a forked process, so that the peak RSS belongs
+ * to that run only. The results are printed to stdout as JSON, and a table is
+ * printed to stderr:
+ * ```
+ * >>> make -C bench TESTLIB_DIR=/path/to/testlib
+ * >>> ./bench/benchmark --label $(git rev-parse --short HEAD) > before.json
+ * ```
+ * Options:
+ * - `--max-n N` the sup of \f$n\f$, default as \f$10^7\f$.
+ * - `--only NAME` run the generators whose name contains NAME only.
+ * - `--label TEXT` the label saved in the JSON, e.g. the commit.
+ *
+ * "elements" is the size \f$n\f$ passed to the generator. Graphs get
+ * \f$m = 2n\f$ edges unless noted. The "MultiCase" cases generate
+ * \f$n / 10\f$ test cases of size \f$10\f$, with and without an `Arena`, and
+ * "TestPack::run" prints \f$n\f$ arrays whose total size is \f$2n\f$.
+ * "TreeRegistry::unique" generates \f$n / 20\f$ distinct trees of size
+ * \f$20\f$, and the enumerators step \f$n\f$ times.
+ * "Queries" and the dynamic streams generate \f$q = n\f$ operations.
+ */
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include "generator.h"
+
+// Atomic, as the worker threads of generator.h allocate too.
+static std::atomic<size_t> allocs{0};  ///< The count of `operator new` calls.
+static std::atomic<size_t> alloc_bytes{0};  ///< The bytes it was asked for.
+
+void* operator new(size_t size) {
+    allocs.fetch_add(1, std::memory_order_relaxed);
+    alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+// Not inlined, or GCC pairs the `free` with the `operator new` of the caller
+// and warns of a mismatch.
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    std::free(p);
+}
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+/**
+ *  @brief  A generator to be measured.
+ */
+struct Case {
+    std::string name;               ///< The name in the results.
+    int max_n;                      ///< The sup of \f$n\f$ of this case.
+    std::function<void(int)> run;  ///< Generate once with size \f$n\f$.
+};
+
+/**
+ *  @brief  The result of one case with one \f$n\f$, sent by the child.
+ */
+struct Result {
+    int ok;
+    int reps;
+    double seconds;
+    size_t allocs, alloc_bytes;
+};
+
+static int sink = 0;  ///< Keeps the results alive.
+
+std::vector<Case> cases() {
+    static Tree tree;
+    static Array<int> arr;
+    static Array<i64_ll> larr;
+    static Graph graph;
+    static String str;
+    auto keep = [](const Tree& t) { sink += t.fa.back(); };
+    // n / 10 test cases of size 10, as in a multi-test problem.
+    auto small_cases = [=](int n) {
+        for (int t = 0; t < n / 10; t++) {
+            keep(tree.sqrt_height_tree(10));
+            keep(tree.n_deg_tree(10));
+            sink += graph.DAG(10, 20).m + graph.regular(10, 3).m;
+            sink += arr.permutation(10)[10];
+        }
+    };
+    return {
+        {"Tree::sqrt_height_tree", 10000000,
+         [=](int n) { keep(tree.sqrt_height_tree(n)); }},
+        {"Tree::log_height_tree", 10000000,
+         [=](int n) { keep(tree.log_height_tree(n)); }},
+        {"Tree::chain", 10000000, [=](int n) { keep(tree.chain(n)); }},
+        {"Tree::flower", 10000000, [=](int n) { keep(tree.flower(n)); }},
+        {"Tree::n_deg_tree", 10000000,
+         [=](int n) { keep(tree.n_deg_tree(n)); }},
+        {"Tree::chain_and_flower", 10000000,
+         [=](int n) { keep(tree.chain_and_flower(n)); }},
+        {"Tree::random_shaped_tree", 10000000,
+         [=](int n) { keep(tree.random_shaped_tree(n)); }},
+        {"Tree::diameter_tree", 10000000,
+         [=](int n) { keep(tree.diameter_tree(n, n / 2)); }},
+        {"Tree::bounded_degree_tree", 10000000,
+         [=](int n) { keep(tree.bounded_degree_tree(n, 3)); }},
+        {"Tree::caterpillar", 10000000,
+         [=](int n) { keep(tree.caterpillar(n, n / 2)); }},
+        {"Tree::broom", 10000000, [=](int n) { keep(tree.broom(n, n / 2)); }},
+        {"Tree::info", 10000000,
+         [=](int n) {
+             static int last = 0;
+             if (last != n)
+                 tree.log_height_tree(n), last = n;
+             sink += tree.info().diameter;
+         }},
+        {"Tree::canonical_hash", 10000000,
+         [=](int n) {
+             static int last = 0;
+             if (last != n)
+                 tree.log_height_tree(n), last = n;
+             sink += tree.canonical_hash();
+         }},
+        {"LabelledTrees::next", 10000000,
+         [=](int n) {
+             static LabelledTrees all;
+             all.init(12);
+             for (int i = 0; i < n; i++)
+                 all.next();
+             keep(all.tree);
+         }},
+        {"RootedTrees::next", 10000000,
+         [=](int n) {
+             static RootedTrees all;
+             all.init(30);
+             for (int i = 0; i < n; i++)
+                 all.next();
+             keep(all.tree);
+         }},
+        {"TreeRegistry::unique", 10000000,
+         [=](int n) {
+             TreeRegistry seen;
+             for (int t = 0; t < n / 20; t++)
+                 seen.unique(tree, [](Tree& x) { x.random_shaped_tree(20); });
+             sink += seen.size();
+         }},
+        {"Array::basic_gen", 10000000,
+         [=](int n) { sink += arr.basic_gen(n, 1, 1000000000)[n]; }},
+        {"Array::binary_gen", 10000000,
+         [=](int n) { sink += arr.binary_gen(n)[n]; }},
+        {"Array::ascending_array", 10000000,
+         [=](int n) { sink += arr.ascending_array(n, 1, 1000000000)[n]; }},
+        {"Array::basic_gen<L,R>", 10000000,
+         [=](int n) { sink += arr.basic_gen<1, 1000000000>(n)[n]; }},
+        {"Array::basic_gen<-R,-L>", 10000000,
+         [=](int n) { sink += arr.basic_gen<-1000000000, -1>(n)[n]; }},
+        {"Array::sum", 10000000,
+         [=](int n) {
+             static int last = 0;
+             if (last != n)
+                 arr.basic_gen(n, 1, 1000000000), last = n;
+             sink += int(arr.sum());
+         }},
+        {"LazyArray::sum", 10000000,
+         [=](int n) {
+             LazyArray<int> lazy;
+             sink += int(lazy.basic_gen(n, 1, 1000000000).sum());
+         }},
+        {"LazyArray::print", 10000000,
+         [=](int n) {
+             LazyArray<int> lazy;
+             _out.open("/dev/null");
+             lazy.basic_gen(n, 1, 1000000000).print();
+             _out.close();
+         }},
+        {"ArrayBox::next", 10000000,
+         [=](int n) {
+             static ArrayBox<int> all;
+             all.init(12, 1, 10);
+             for (int i = 0; i < n; i++)
+                 sink += all.next();
+         }},
+        {"RangedArray::gen", 10000000,
+         [=](int n) {
+             static RangedArray<0, 1000> ranged;
+             sink += ranged.gen(n)[n];
+         }},
+        {"RangedArray::gen(negative)", 10000000,
+         [=](int n) {
+             static RangedArray<-1000, -1> ranged;
+             sink += ranged.gen(n)[n];
+         }},
+        {"Array::permutation", 10000000,
+         [=](int n) { sink += arr.permutation(n)[n]; }},
+        {"Array::antiqsort", 10000000,
+         [=](int n) { sink += arr.antiqsort(n).n; }},
+        {"Array::median_of_three_killer", 10000000,
+         [=](int n) { sink += arr.median_of_three_killer(n).n; }},
+        {"Array::hash_killer", 1000000,
+         [=](int n) {
+             static Array<i64_ll> keys;
+             sink += keys.hash_killer(n, 1000000000000000000ll).n;
+         }},
+        {"Array::constant_sum", 10000000,
+         [=](int n) {
+             sink += larr.constant_sum(n, 1000000000000ll, false, false)[n];
+         }},
+        {"Queries::gen", 10000000,
+         [=](int n) {
+             static Queries<int> qs;
+             sink += qs.gen(n, n, 1, 1000000000).queries[n].r;
+         }},
+        {"Queries::gen(mo_adversary)", 10000000,
+         [=](int n) {
+             static Queries<int> qs;
+             qs.gen(n, n, 1, 1000000000, {0, 0, 1}, QueryLength::mo_adversary);
+             sink += qs.queries[n].r;
+         }},
+        {"Queries::print", 10000000,
+         [=](int n) {
+             static Queries<int> qs;
+             if (qs.q != n)
+                 qs.gen(n, n, 1, 1000000000);
+             _out.open("/dev/null"), qs.print(), _out.close();
+         }},
+        {"Graph::randomly_gen", 10000000,
+         [=](int n) { sink += graph.randomly_gen(n, 2 * n).m; }},
+        {"Graph::DAG", 10000000, [=](int n) { sink += graph.DAG(n, 2 * n).m; }},
+        {"Graph::forest", 10000000, [=](int n) { sink += graph.forest(n).m; }},
+        {"Graph::hack_spfa", 10000000,
+         [=](int n) { sink += graph.hack_spfa(n, 2 * n).m; }},
+        {"Graph::hack_bellman_ford", 10000000,
+         [=](int n) { sink += graph.hack_bellman_ford(n, 2 * n).m; }},
+        {"Graph::hack_dijkstra", 10000000,
+         [=](int n) { sink += graph.hack_dijkstra(n, 2 * n).m; }},
+        {"Graph::bipartite", 10000000,
+         [=](int n) { sink += graph.bipartite(n / 2, n - n / 2, 2 * n).m; }},
+        {"Graph::regular(d=4)", 10000000,
+         [=](int n) { sink += graph.regular(n, 4).m; }},
+        {"Graph::cactus", 10000000, [=](int n) { sink += graph.cactus(n).m; }},
+        {"Graph::planar", 10000000, [=](int n) { sink += graph.planar(n).m; }},
+        {"Graph::tournament", 10000,
+         [=](int n) { sink += graph.tournament(n).m; }},
+        {"DynamicForest::gen", 1000000,
+         [=](int n) {
+             static DynamicForest df;
+             df.init(tree.log_height_tree(n)).gen(n, {1, 1, 1}, true);
+             sink += df.q;
+         }},
+        {"DynamicGraph::gen", 10000000,
+         [=](int n) {
+             static DynamicGraph dg;
+             dg.init(graph.randomly_gen(n, n)).gen(n);
+             sink += dg.q;
+         }},
+        {"String::gen", 10000000,
+         [=](int n) { sink += str.gen("[a-z]{%d}", n).size(); }},
+        {"String::lower", 10000000,
+         [=](int n) { sink += str.lower(n).size(); }},
+        {"_random::shuffle", 10000000,
+         [=](int n) {
+             std::vector<int> v(n + 1);
+             sink += _rnd.shuffle(v)[n];
+         }},
+        {"_random::get_prime(x1000)", 10000000,
+         [=](int n) {
+             for (int i = 0; i < 1000; i++)
+                 sink += _rnd.get_prime(1ll, 1ll * n * n);
+         }},
+        {"MultiCase::heap", 10000000, small_cases},
+        {"MultiCase::arena", 10000000,
+         [=](int n) {
+             static Arena arena;
+             for (int t = 0; t < n / 10; t++) {
+                 ArenaScope scope(arena);
+                 small_cases(10);
+             }
+         }},
+        {"TestPack::run", 10000000,
+         [=](int n) {
+             static TestPack pack;
+             _out.open("/dev/null");
+             pack.split(2 * n, n).run(arr, [](Array<int>& a, int size) {
+                 _out.println(size), a.basic_gen(size, 1, 1000000000).print();
+             });
+             _out.close();
+         }},
+        {"Output::text", 10000000,
+         [=](int n) {
+             static int last = 0;
+             if (last != n)
+                 arr.basic_gen(n, 1, 1000000000), last = n;
+             _out.open("/dev/null"), arr.print(), _out.close();
+         }},
+        {"Output::parallel", 10000000,
+         [=](int n) {
+             static int last = 0;
+             if (last != n)
+                 arr.basic_gen(n, 1, 1000000000), last = n;
+             _out.open("/dev/null"), arr.print_parallel(), _out.close();
+         }},
+        {"Output::binary", 10000000,
+         [=](int n) {
+             static int last = 0;
+             if (last != n)
+                 arr.basic_gen(n, 1, 1000000000), last = n;
+             _out.open("/dev/null", OutputMode::binary);
+             arr.print(), _out.close();
+         }},
+        {"Output::gzip", 10000000,
+         [=](int n) {
+             static int last = 0;
+             if (last != n)
+                 arr.basic_gen(n, 1, 1000000000), last = n;
+             _out.open("/dev/null", OutputMode::text, true);
+             arr.print(), _out.close();
+         }},
+    };
+}
+
+/**
+ *  @brief  Run `c` with size `n` in the current process, repeating small
+ * sizes until it takes about 0.2s.
+ */
+Result measure(const Case& c, int n) {
+    using clock = std::chrono::steady_clock;
+    c.run(n);  // warm up, and fill the static objects.
+    Result res{1, 0, 0, 0, 0};
+    size_t a0 = allocs.load(), b0 = alloc_bytes.load();
+    auto start = clock::now();
+    do {
+        c.run(n), res.reps++;
+        res.seconds =
+            std::chrono::duration<double>(clock::now() - start).count();
+    } while (res.seconds < 0.2 && res.reps < 1000);
+    res.allocs = (allocs.load() - a0) / res.reps;
+    res.alloc_bytes = (alloc_bytes.load() - b0) / res.reps;
+    return res;
+}
+
+int main(int argc, char** argv) {
+    int max_n = 10000000;
+    std::string only, label;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string opt = argv[i];
+        if (opt == "--max-n")
+            max_n = std::atoi(argv[i + 1]);
+        else if (opt == "--only")
+            only = argv[i + 1];
+        else if (opt == "--label")
+            label = argv[i + 1];
+        else
+            Quit("Unknown option:", opt);
+    }
+    char* seed_argv[] = {argv[0], nullptr};
+    registerGen(1, seed_argv, 1);
+    std::printf("{\"label\": \"%s\", \"results\": [", label.c_str());
+    std::fprintf(stderr, "%-28s %9s %12s %12s %12s\n", "generator", "n",
+                 "ns/element", "peak RSS/KB", "allocs");
+    bool first = true;
+    for (const Case& c : cases()) {
+        if (c.name.find(only) == std::string::npos)
+            continue;
+        for (int n = 1000; n <= std::min(max_n, c.max_n); n *= 10) {
+            int fds[2];
+            if (pipe(fds))
+                Quit("pipe() failed.");
+            std::fflush(stdout), std::fflush(stderr);
+            pid_t pid = fork();
+            if (pid == 0) {
+                Result res = measure(c, n);
+                if (write(fds[1], &res, sizeof res) != sizeof res)
+                    _exit(1);
+                _exit(0);
+            }
+            close(fds[1]);
+            Result res{0, 0, 0, 0, 0};
+            if (read(fds[0], &res, sizeof res) != sizeof res)
+                res.ok = 0;
+            close(fds[0]);
+            int status;
+            struct rusage usage;
+            wait4(pid, &status, 0, &usage);
+            double ns = res.ok ? res.seconds * 1e9 / res.reps / n : 0;
+            std::printf(
+                "%s\n  {\"name\": \"%s\", \"n\": %d, \"ok\": %s, \"reps\": %d, "
+                "\"ns_per_element\": %.3f, \"peak_rss_kb\": %ld, "
+                "\"allocs\": %zu, \"alloc_bytes\": %zu}",
+                first ? "" : ",", c.name.c_str(), n, res.ok ? "true" : "false",
+                res.reps, ns, usage.ru_maxrss, res.allocs, res.alloc_bytes);
+            first = false;
+            if (res.ok)
+                std::fprintf(stderr, "%-28s %9d %12.2f %12ld %12zu\n",
+                             c.name.c_str(), n, ns, usage.ru_maxrss,
+                             res.allocs);
+            else
+                std::fprintf(stderr, "%-28s %9d %12s\n", c.name.c_str(), n,
+                             "FAILED");
+        }
+    }
+    std::printf("\n]}\n");
+    return sink == 42;
+}
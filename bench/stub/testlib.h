@@ -0,0 +1,153 @@
+/**
+ *  @file testlib.h
+ *  @brief  A minimal stand-in for testlib.h, so that the benchmark builds
+ * out of the box. It has only what generator.h uses: `rnd`, `format`,
+ * `ensure`, `println` and `registerGen`. The patterns of `rnd.next` are
+ * only the chars and the classes like `[a-z0-9]`, each repeated by an
+ * optional `{n}` or `{a,b}`.
+ *
+ * `rnd` draws from `std::mt19937_64` instead of the generator of testlib,
+ * so the data differ, and the timings of the draws differ a little. To
+ * compare with the real library, build with
+ * `make -C bench TESTLIB_DIR=/path/to/testlib`.
+ */
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ *  @brief  Format like `printf` into a `std::string`.
+ */
+inline std::string format(const char* fmt, ...) {
+    char buf[4096];
+    va_list ap;
+    va_start(ap, fmt);
+    std::vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    return buf;
+}
+
+#define ensure(cond)                                               \
+    do {                                                           \
+        if (!(cond)) {                                             \
+            std::fprintf(stderr, "ensure failed: %s\n", #cond);    \
+            std::exit(3);                                          \
+        }                                                          \
+    } while (0)
+
+/**
+ *  @brief  The subset of `random_t` of testlib that generator.h uses.
+ */
+struct random_t {
+    std::mt19937_64 gen{42};
+
+    void setSeed(unsigned long long seed) { gen.seed(seed); }
+    /// A value in \f$[0, n)\f$.
+    template <typename _Tp>
+    _Tp next(_Tp n) {
+        if constexpr (std::is_floating_point<_Tp>::value)
+            return n * next();
+        else
+            return std::uniform_int_distribution<_Tp>(0, n - 1)(gen);
+    }
+    /// A value in \f$[a, b]\f$.
+    template <typename _Tp>
+    _Tp next(_Tp a, _Tp b) {
+        if constexpr (std::is_floating_point<_Tp>::value)
+            return a + (b - a) * next();
+        else
+            return std::uniform_int_distribution<_Tp>(a, b)(gen);
+    }
+    /// A string matching `pattern`.
+    std::string next(const std::string& pattern) {
+        std::string res;
+        for (size_t i = 0; i < pattern.size();) {
+            std::string chars;
+            if (pattern[i] == '[') {
+                for (i++; i < pattern.size() && pattern[i] != ']'; i++)
+                    if (i + 2 < pattern.size() && pattern[i + 1] == '-' &&
+                        pattern[i + 2] != ']')
+                        for (char c = pattern[i], e = pattern[i += 2]; c <= e;
+                             c++)
+                            chars.push_back(c);
+                    else
+                        chars.push_back(pattern[i]);
+                i++;
+            } else {
+                chars.push_back(pattern[i++]);
+            }
+            long long lo = 1, hi = 1;
+            if (i < pattern.size() && pattern[i] == '{') {
+                size_t end = pattern.find('}', i);
+                std::string range = pattern.substr(i + 1, end - i - 1);
+                size_t comma = range.find(',');
+                lo = std::atoll(range.c_str());
+                hi = comma == std::string::npos
+                         ? lo
+                         : std::atoll(range.c_str() + comma + 1);
+                i = end + 1;
+            }
+            for (long long k = next(lo, hi); k > 0; k--)
+                res.push_back(chars[next(int(chars.size()))]);
+        }
+        return res;
+    }
+    /// A value in \f$[0, 1)\f$.
+    double next() {
+        return std::uniform_real_distribution<double>(0, 1)(gen);
+    }
+    /// The max of \f$t + 1\f$ draws of `next(n)`, or the min if \f$t < 0\f$.
+    template <typename _Tp>
+    _Tp wnext(_Tp n, int t) {
+        _Tp res = next(n);
+        for (int i = 0; i < t; i++)
+            res = std::max(res, next(n));
+        for (int i = 0; i < -t; i++)
+            res = std::min(res, next(n));
+        return res;
+    }
+    template <typename _Container>
+    typename _Container::value_type any(const _Container& c) {
+        auto it = c.begin();
+        std::advance(it, next(int(c.size())));
+        return *it;
+    }
+    /// A random permutation of \f$[first, first + n)\f$.
+    std::vector<int> perm(int n, int first = 0) {
+        std::vector<int> p(n);
+        for (int i = 0; i < n; i++)
+            p[i] = first + i;
+        std::shuffle(p.begin(), p.end(), gen);
+        return p;
+    }
+} rnd;
+
+/**
+ *  @brief  Seed `rnd` by the arguments, like testlib does.
+ */
+inline void registerGen(int argc, char** argv, int) {
+    unsigned long long seed = 1;
+    for (int i = 1; i < argc; i++)
+        for (const char* p = argv[i]; *p; p++)
+            seed = seed * 131 + *p;
+    rnd.setSeed(seed);
+}
+
+inline void println() { std::cout << '\n'; }
+template <typename _Tp, typename... Args>
+void println(const _Tp& first, const Args&... rest) {
+    std::cout << first;
+    ((std::cout << ' ' << rest), ...);
+    std::cout << '\n';
+}
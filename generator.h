@@ -58,10 +58,32 @@
  * ```
  * Then it's expected to generate some different data.
  *  */
+#include <array>
 #include <cassert>
+#include <cerrno>
+#include <climits>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <numeric>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
+#ifdef __unix__
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 #include "testlib.h"
 
 using i64_ll = long long;
@@ -81,6 +103,99 @@ struct GenException : public std::exception {
     const char* what() const throw() { return _msg.data(); }
 };
 
+/**
+ *  @brief  Optional instrumentation, enabled by `#define CPGEN_PROFILE` before
+ * including this file. Every instrumented generator counts the RNG draws and
+ * rejected samples of its sampling loops, the allocations of its containers,
+ * the bytes it writes and the time it takes, and a summary is
+ * printed to stderr at exit. If the environment variable
+ * `CPGEN_PROFILE_JSON` is set, the summary is written to that file as JSON
+ * instead. When disabled, the macros expand to nothing.
+ */
+#ifdef CPGEN_PROFILE
+#include <chrono>
+#include <deque>
+
+/**
+ *  @brief  The counters of one instrumented call site.
+ */
+struct _ProfileSite {
+    const char* name;
+    unsigned long long calls = 0, draws = 0, rejects = 0, allocs = 0,
+                       alloc_bytes = 0, written = 0;
+    double seconds = 0;  ///< Including the nested sites.
+};
+
+/**
+ *  @brief  Owns the sites, so they are still alive when it dumps them.
+ */
+class _Profiler {
+   public:
+    std::deque<_ProfileSite> sites{{"(unscoped)"}};
+    _ProfileSite* current = &sites.front();  ///< The innermost site.
+    inline _ProfileSite* site(const char* name) {
+        sites.push_back({name});
+        return &sites.back();
+    }
+    ~_Profiler() {
+        const char* path = std::getenv("CPGEN_PROFILE_JSON");
+        std::FILE* f = path ? std::fopen(path, "w") : nullptr;
+        if (f) {
+            std::fprintf(f, "{\"sites\": [");
+            for (size_t i = 0; i < sites.size(); i++)
+                std::fprintf(f,
+                             "%s\n  {\"name\": \"%s\", \"calls\": %llu, "
+                             "\"draws\": %llu, \"rejects\": %llu, "
+                             "\"allocs\": %llu, \"alloc_bytes\": %llu, "
+                             "\"written\": %llu, \"seconds\": %.6f}",
+                             i ? "," : "", sites[i].name, sites[i].calls,
+                             sites[i].draws, sites[i].rejects, sites[i].allocs,
+                             sites[i].alloc_bytes, sites[i].written,
+                             sites[i].seconds);
+            std::fprintf(f, "\n]}\n"), std::fclose(f);
+            return;
+        }
+        std::fprintf(stderr, "%-28s %8s %12s %12s %8s %12s %12s %9s\n",
+                     "CPgen profile", "calls", "draws", "rejects", "allocs",
+                     "alloc_bytes", "written", "seconds");
+        for (const _ProfileSite& s : sites)
+            if (s.calls || s.draws || s.written)
+                std::fprintf(stderr,
+                             "%-28s %8llu %12llu %12llu %8llu %12llu %12llu "
+                             "%9.3f\n",
+                             s.name, s.calls, s.draws, s.rejects, s.allocs,
+                             s.alloc_bytes, s.written, s.seconds);
+    }
+} _profiler;
+
+/**
+ *  @brief  Makes `site` the innermost site while it is alive.
+ */
+struct _ProfileScope {
+    _ProfileSite *site, *saved;
+    std::chrono::steady_clock::time_point start;
+    _ProfileScope(_ProfileSite* s)
+        : site(s), saved(_profiler.current),
+          start(std::chrono::steady_clock::now()) {
+        site->calls++, _profiler.current = site;
+    }
+    ~_ProfileScope() {
+        site->seconds += std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+        _profiler.current = saved;
+    }
+};
+
+#define CPGEN_PROFILE_SCOPE(name)                                 \
+    static _ProfileSite* _cpgen_site = _profiler.site(name);     \
+    _ProfileScope _cpgen_scope(_cpgen_site)
+#define CPGEN_PROFILE_COUNT(field, k) (_profiler.current->field += (k))
+#else
+#define CPGEN_PROFILE_SCOPE(name) ((void)0)
+#define CPGEN_PROFILE_COUNT(field, k) ((void)0)
+#endif
+
 /**
  *  @brief  Print some infomation to standard output and quit.
  *  @param  params Any. Anything that can be printed, with any number.
@@ -105,8 +220,8 @@ inline i64_ll qpow(i64_ll a, i64_ll b, i64_ll mod) {
     i128_ll ans = 1;
     while (b) {
         if (b & 1)
-            ans = 1ll * ans * a % mod;
-        a = 1ll * a * a % mod;
+            ans = ans * a % mod;
+        a = i128_ll(a) * a % mod;
         b >>= 1;
     }
     return ans;
@@ -143,6 +258,17 @@ inline bool is_prime(i64_ll n) {
     return 1;
 }
 
+/**
+ *  @brief  One step of splitmix64: the \f$i\f$-th output of splitmix64
+ * seeded with \f$s\f$ is `_mix64(s + i * 0x9e3779b97f4a7c15)`.
+ */
+inline unsigned long long _mix64(unsigned long long x) {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
 /**
  *  @brief  Expansion of random_t.
  */
@@ -150,20 +276,18 @@ class _random {
    public:
     /**
      *  @brief  Shuffle the array in-place, indexes from \f$l\f$ to \f$r\f$.
-     *  @param array Any std::vector<_Tp>.
+     *  @param array Any std::vector, pass it by `std::move` to avoid copying.
      *  @param l The left bound that should be shuffled. Default as \f$1\f$.|
      *  @param r The right bound that should be shuffled. Default as
      * `array.size()`.
      *  @return Return the result.
      */
-    template <typename _Tp>
-    inline std::vector<_Tp> shuffle(std::vector<_Tp> array,
-                                    int l = 1,
-                                    int r = -1) {
+    template <typename _Sequence>
+    inline _Sequence shuffle(_Sequence array, int l = 1, int r = -1) {
         if (!~r)
             r = array.size() - 1;
         for (int i = l + 1; i <= r; i++)
-            std::swap(array.at(i), array.at(rnd.next(l, i - 1)));
+            std::swap(array.at(i), array.at(rnd.next(l, i)));
         return array;
     }
     /**
@@ -178,12 +302,14 @@ class _random {
      */
     template <typename _Tp>
     inline _Tp get_prime(_Tp l, _Tp r) {
+        CPGEN_PROFILE_SCOPE("_random::get_prime");
         int times = 5;
         while (times-- > 0) {
             _Tp base = rnd.next(l, r);
+            CPGEN_PROFILE_COUNT(draws, 1);
             while (!is_prime(base) && base <= r)
-                base++;
-            if (base == r)
+                base++, CPGEN_PROFILE_COUNT(rejects, 1);
+            if (base > r)
                 continue;
             return base;
         }
@@ -193,650 +319,4035 @@ class _random {
 } _rnd;
 
 /**
- *  @brief print a vector.
- *  @param vec Any std::vector<_Tp>.
- *  @param sep The seperator.
- *  @param end the end char.
- *  @return no return.
- *  @throw Throws exception when element is not print-able.
+ *  @brief  A bump allocator for the scratch buffers of the generators. It
+ * hands out memory from big chunks and never frees a single buffer, so a
+ * buffer costs a pointer bump instead of a malloc/free pair; `rewind()`
+ * takes back everything allocated since a `mark()` in \f$O(1)\f$, and keeps
+ * the chunks for the next test case. Use it through `ArenaScope`.
  */
-template <typename T>
-inline void print(std::vector<T> vec, char sep = ' ', char end = '\n') {
-    for (auto&& i : vec) {
-        std::cout << i << sep;
+class Arena {
+   public:
+    /**
+     *  @brief  A position in the arena, see `mark()` and `rewind()`.
+     */
+    struct Mark {
+        size_t chunk, used;
+    };
+    /**
+     *  @param  chunk_size the size of the first chunk, in bytes. Each new
+     * chunk is twice as large as the last one.
+     */
+    explicit Arena(size_t chunk_size = 1 << 16) : _chunk_size(chunk_size) {}
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    ~Arena() {
+        for (auto& chunk : _chunks)
+            ::operator delete(chunk.first);
+    }
+    /**
+     *  @brief  Allocate `bytes` bytes, in amortized \f$O(1)\f$.
+     *  @param  bytes the size of the memory.
+     *  @param  align the alignment, at most `alignof(std::max_align_t)`.
+     *  @return The memory, valid until the arena is rewound past it.
+     *  @throw  It throws what `operator new` throws.
+     */
+    inline void* allocate(size_t bytes,
+                          size_t align = alignof(std::max_align_t)) {
+        assert(align <= alignof(std::max_align_t));
+        for (; _cur < _chunks.size(); _cur++, _used = 0) {
+            size_t at = (_used + align - 1) & ~(align - 1);
+            if (at + bytes <= _chunks[_cur].second) {
+                _used = at + bytes;
+                return _chunks[_cur].first + at;
+            }
+        }
+        size_t size = _chunks.empty() ? _chunk_size : 2 * _chunks.back().second;
+        size = std::max(size, bytes);
+        CPGEN_PROFILE_COUNT(allocs, 1), CPGEN_PROFILE_COUNT(alloc_bytes, size);
+        _chunks.push_back({static_cast<char*>(::operator new(size)), size});
+        _cur = _chunks.size() - 1, _used = bytes;
+        return _chunks.back().first;
+    }
+    /**
+     *  @brief  The current position, to be passed to `rewind()`.
+     */
+    inline Mark mark() const { return {_cur, _used}; }
+    /**
+     *  @brief  Free everything allocated since `pos` was marked, in
+     * \f$O(1)\f$.
+     */
+    inline void rewind(Mark pos) { _cur = pos.chunk, _used = pos.used; }
+    /**
+     *  @brief  Free everything, keeping the chunks.
+     */
+    inline void reset() { rewind({0, 0}); }
+    /**
+     *  @brief  The total size of the chunks, in bytes.
+     */
+    inline size_t capacity() const {
+        size_t res = 0;
+        for (auto& chunk : _chunks)
+            res += chunk.second;
+        return res;
     }
-    std::cout << end;
-}
 
-#define warn printf
+   private:
+    std::vector<std::pair<char*, size_t>> _chunks;  ///< [memory, size].
+    size_t _chunk_size;  ///< The size of the first chunk.
+    size_t _cur = 0;     ///< The chunk being allocated from.
+    size_t _used = 0;    ///< The bytes used in `_chunks[_cur]`.
+};
+
+Arena* _arena = nullptr;  ///< The arena of the current test case, if any.
 
 /**
- *  @brief  Class that used to generate a tree.
+ *  @brief  The allocator of the scratch buffers. It allocates from `arena`,
+ * or from the heap when `arena` is `nullptr`, i.e. outside of any
+ * `ArenaScope`.
  */
-class Tree {
+template <typename _Tp>
+struct ArenaAllocator {
+    using value_type = _Tp;
+    Arena* arena;  ///< Where the memory comes from.
+    ArenaAllocator(Arena* a = nullptr) : arena(a) {}
+    template <typename _Up>
+    ArenaAllocator(const ArenaAllocator<_Up>& rhs) : arena(rhs.arena) {}
+    inline _Tp* allocate(size_t count) {
+        if (arena)
+            return static_cast<_Tp*>(
+                arena->allocate(count * sizeof(_Tp), alignof(_Tp)));
+        return std::allocator<_Tp>().allocate(count);
+    }
+    inline void deallocate(_Tp* ptr, size_t count) {
+        if (!arena)
+            std::allocator<_Tp>().deallocate(ptr, count);
+    }
+    template <typename _Up>
+    inline bool operator==(const ArenaAllocator<_Up>& rhs) const {
+        return arena == rhs.arena;
+    }
+    template <typename _Up>
+    inline bool operator!=(const ArenaAllocator<_Up>& rhs) const {
+        return arena != rhs.arena;
+    }
+};
+
+/**
+ *  @brief  Makes `arena` the arena of the scratch buffers while it is alive,
+ * and takes their memory back when it dies. Create one per test case, so the
+ * cases share the same few chunks:
+ * ```
+ * Arena arena;
+ * for (int t = 1; t <= T; t++) {
+ *     ArenaScope scope(arena);
+ *     tree.sqrt_height_tree(10).print(1);
+ * }
+ * ```
+ * The objects (`Tree`, `Array`, ...) keep their own containers, whose
+ * capacity is reused when the same object generates the next case.
+ */
+struct ArenaScope {
+    Arena *arena, *saved;
+    Arena::Mark pos;
+    ArenaScope(Arena& a) : arena(&a), saved(_arena), pos(a.mark()) {
+        _arena = arena;
+    }
+    ~ArenaScope() { arena->rewind(pos), _arena = saved; }
+};
+
+/**
+ *  @brief  A temporary buffer inside a generator, see `_scratch()`.
+ */
+template <typename _Tp>
+using _Buffer = std::vector<_Tp, ArenaAllocator<_Tp>>;
+
+/**
+ *  @brief  Make a zero-filled scratch buffer of `size` elements on the
+ * current arena. It must not outlive the generator that made it.
+ */
+template <typename _Tp>
+inline _Buffer<_Tp> _scratch(size_t size = 0) {
+    return _Buffer<_Tp>(size, ArenaAllocator<_Tp>(_arena));
+}
+
+/**
+ *  @brief  A streaming gzip encoder, using LZ77 with a 32KiB window. Each
+ * chunk becomes one deflate block, with Huffman codes built for it, the
+ * fixed codes, or stored as is, whichever is the smallest, so the output is
+ * never more than a few bytes per chunk larger than the input. The result
+ * can be read by `gzip -d` and zlib.
+ */
+class _Gzip {
    public:
-    int n;                    ///< The size of the tree.
-    std::vector<int> fa;      ///< `fa[i]` is the no. of node \f$i\f$'s father.
-    std::vector<int> leaves;  ///< The no. of leaves. NOTE that it would be
-                              ///< empty UNLESS you call `get_leaves()` method.
-    bool weighted = false;  ///< Denoting if the **edges** are weighted or not.
-    using _Self = Tree;
+    std::string out;  ///< The compressed bytes that have not been written.
     /**
-     *  @brief  Initiate Tree object with size `size`.
-     *  @param  size The count of the nodes that will be generated.
-     *  @return The graph itself.
-     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
+     *  @brief  Start a new gzip member.
      */
-    inline void init(int size) {
-        fa.clear(), leaves.clear();
-        if (size < 1)
-            throw GenException(
-                format("Invalid 'n' has been passed in `init`: %d", size));
-        n = size;
-        fa.resize(size + 1);
+    inline void begin() {
+        out.assign("\x1f\x8b\x08\0\0\0\0\0\0\xff", 10);
+        crc = ~0u, isize = 0, bitbuf = 0, bitcnt = 0;
+        window.clear();
     }
     /**
-     *  @brief  Generate a tree with an expected height of \f$O(\sqrt n)\f$
-     *  @param  size The count of the nodes that will be generated.
-     *  @return The graph itself.
-     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
+     *  @brief  Compress `len` bytes from `data` into a non-final block.
      */
-    inline _Self sqrt_height_tree(int size) {
-        init(size);
-        std::vector<int> p(size - 1);
-        for (int i = 1; i <= size - 2; i++)
-            p.at(i) = rnd.next(1, size);
-        std::vector<int> d(size + 1);
-        for (int i = 1; i <= size - 2; ++i)
-            d.at(p.at(i))++;
-        p.at(size - 1) = size;
-        for (int i = 1, j = 1; i < size; ++i, ++j) {
-            while (d.at(j))
-                ++j;
-            fa.at(j) = p.at(i);
-            while (i < n && !--d.at(p.at(i)) && p.at(i) < j)
-                fa.at(p.at(i)) = p.at(i + 1), ++i;
+    inline void feed(const char* data, size_t len) {
+        static const std::vector<unsigned> table = crc_table();
+        if (!len)
+            return;
+        for (size_t i = 0; i < len; i++)
+            crc = table[(crc ^ (unsigned char)data[i]) & 255] ^ (crc >> 8);
+        isize += len;
+        size_t start = window.size();
+        window.append(data, len);
+        const unsigned char* w = (const unsigned char*)window.data();
+        size_t size = window.size();
+        std::vector<int> head(1 << 15, -1);
+        auto hash = [&](size_t i) {
+            unsigned v = w[i] | w[i + 1] << 8 | w[i + 2] << 16;
+            return (v * 2654435761u) >> 17;
+        };
+        for (size_t i = 0; i + 3 <= start; i++)
+            head[hash(i)] = i;
+        tokens.clear(), lfreq.fill(0), dfreq.fill(0);
+        for (size_t i = start; i < size;) {
+            size_t best = 0, cand = 0;
+            if (i + 3 <= size) {
+                int& slot = head[hash(i)];
+                cand = slot, slot = i;
+                if (cand != size_t(-1) && i - cand <= 32768) {
+                    size_t lim = std::min<size_t>(258, size - i);
+                    while (best < lim && w[cand + best] == w[i + best])
+                        best++;
+                }
+            }
+            if (best < 3) {
+                tokens.push_back(w[i]), lfreq[w[i++]]++;
+                continue;
+            }
+            match(best, i - cand);
+            for (size_t j = i + 1; j < i + best && j + 3 <= size; j++)
+                head[hash(j)] = j;
+            i += best;
         }
-        fa.at(n) = fa.at(1), fa.at(1) = 0;
-        for (int i = 2; i <= size; i++)
-            if (fa.at(i) == 1)
-                fa.at(i) = size;
-        return *this;
+        lfreq[256]++;
+        block(window.data() + start, len);
+        if (window.size() > 32768)
+            window.erase(0, window.size() - 32768);
     }
     /**
-     *  @brief  Generate a tree with an expected height of \f$O(\log n)\f$
-     *  @param  size The count of the nodes that will be generated.
-     *  @return The graph itself.
-     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
+     *  @brief  Write the final block and the trailer.
      */
-    inline _Self log_height_tree(int size) {
-        init(size);
-        for (int i = 2; i <= size; i++)
-            fa.at(i) = rnd.next(1, i - 1);
-        return *this;
+    inline void finish() {
+        bits(1, 1), bits(1, 2), bits(0, 7);  // A fixed block of only 256.
+        for (bits(0, (8 - bitcnt % 8) % 8); bitcnt; bitcnt -= 8)
+            out.push_back(char(bitbuf & 255)), bitbuf >>= 8;
+        for (unsigned v : {~crc, isize})
+            for (int i = 0; i < 4; i++)
+                out.push_back(char(v >> (8 * i) & 255));
+    }
+
+   private:
+    unsigned crc = ~0u, isize = 0;
+    unsigned long long bitbuf = 0;
+    int bitcnt = 0;
+    std::string window;  ///< The last 32KiB of input and the current chunk.
+    /// The symbols of the chunk: a literal, or `len | dist << 9`.
+    std::vector<unsigned> tokens;
+    std::array<unsigned, 286> lfreq;  ///< The counts of literals/lengths.
+    std::array<unsigned, 30> dfreq;   ///< The counts of distances.
+    std::array<unsigned char, 286> llen;  ///< The code lengths of the block.
+    std::array<unsigned char, 30> dlen;
+    std::array<unsigned short, 286> lcode;  ///< The codes, bit-reversed.
+    std::array<unsigned short, 30> dcode;
+    /// The code lengths of a dynamic block, as (symbol, extra bits).
+    std::vector<std::pair<int, int>> rle;
+    static inline std::vector<unsigned> crc_table() {
+        std::vector<unsigned> table(256);
+        for (unsigned i = 0; i < 256; i++) {
+            unsigned c = i;
+            for (int k = 0; k < 8; k++)
+                c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        return table;
     }
     /**
-     *  @brief  Generate a tree that is a chain.
-     *  @param  size The count of the nodes that will be generated.
-     *  @return The graph itself.
-     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
+     *  @brief  Append the `n` low bits of `v`. Huffman codes should be passed
+     * bit-reversed, as deflate packs them starting from the MSB.
      */
-    inline _Self chain(int size) {
-        init(size);
-        for (int i = 2; i <= size; i++)
-            fa.at(i) = i - 1;
-        return *this;
+    inline void bits(unsigned v, int n) {
+        bitbuf |= (unsigned long long)v << bitcnt, bitcnt += n;
+        if (bitcnt >= 32) {
+            char tmp[4] = {char(bitbuf), char(bitbuf >> 8), char(bitbuf >> 16),
+                           char(bitbuf >> 24)};
+            out.append(tmp, 4), bitbuf >>= 32, bitcnt -= 32;
+        }
+    }
+    static constexpr int lbase[29] = {
+        3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+        31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static constexpr int dbase[30] = {
+        1,    2,    3,    4,    5,    7,    9,    13,    17,    25,
+        33,   49,   65,   97,   129,  193,  257,  385,   513,   769,
+        1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    /// The extra bits of the length symbol \f$257 + l\f$ and distance `d`.
+    static int lextra(int l) { return l >= 8 && l < 28 ? (l - 4) / 4 : 0; }
+    static int dextra(int d) { return d >= 4 ? (d - 2) / 2 : 0; }
+    /// The extra bits of the repeat symbols of the code lengths.
+    static int _rle_extra(int sym) {
+        return sym == 16 ? 2 : sym == 17 ? 3 : sym == 18 ? 7 : 0;
+    }
+    /// The length of the fixed Huffman code of the literal/length `s`.
+    static int _fixed_length(int s) {
+        return s < 144 ? 8 : s < 256 ? 9 : s < 280 ? 7 : 8;
     }
     /**
-     *  @brief  Generate a tree that is a flower.
-     *  @param  size The count of the nodes that will be generated.
-     *  @return The graph itself.
-     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
+     *  @brief  The length symbol (minus 257) of `len` and the distance symbol
+     * of `dist`, by tables indexed as in zlib.
      */
-    inline _Self flower(int size) {
-        init(size);
-        for (int i = 2; i <= size; i++)
-            fa.at(i) = 1;
-        return *this;
+    static inline std::pair<int, int> symbols(int len, int dist) {
+        static const auto lsym = [] {
+            std::array<unsigned char, 259> res{};
+            for (int i = 3, l = 0; i <= 258; i++)
+                res[i] = l += l < 28 && lbase[l + 1] <= i;
+            return res;
+        }();
+        static const auto dsym = [] {
+            std::array<unsigned char, 512> res{};
+            for (int i = 1, d = 0; i <= 32768; i++) {
+                d += d < 29 && dbase[d + 1] <= i;
+                res[i <= 256 ? i - 1 : 256 + ((i - 1) >> 7)] = d;
+            }
+            return res;
+        }();
+        return {lsym[len],
+                dsym[dist <= 256 ? dist - 1 : 256 + ((dist - 1) >> 7)]};
+    }
+    inline void match(int len, int dist) {
+        auto [l, d] = symbols(len, dist);
+        tokens.push_back(len | dist << 9), lfreq[257 + l]++, dfreq[d]++;
     }
     /**
-     *  @brief  Generate a tree with an expected max_deg of \f$O(n)\f$.
-     *  @param  size The count of the nodes that will be generated.
-     *  @return The graph itself.
-     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
+     *  @brief  The lengths of a Huffman code for `freq`, at most `limit`. At
+     * least two symbols get a code, so that the code is complete. When the
+     * code is too deep, the counts are halved and it is built again.
      */
-    inline _Self n_deg_tree(int size) {
-        init(size);
-        int flowers_count = rnd.next(1, 10);
-        std::vector<int> is_flower(size + 1);
-        for (int i = 1; i <= size; i++)
-            is_flower.at(i) = 0;
-        std::vector<int> nodes;
-        for (int i = 1; i <= flowers_count; i++) {
-            int node = rnd.next(1, size);
-            if (is_flower.at(node) == 1) {
-                i--;
-                continue;
+    template <size_t N>
+    static void huffman(const std::array<unsigned, N>& freq, int limit,
+                        std::array<unsigned char, N>& len) {
+        std::array<unsigned, N> f = freq;
+        for (size_t i = 0, used = std::count_if(f.begin(), f.end(),
+                                                [](unsigned x) { return x; });
+             used < 2; i++)
+            if (!f[i])
+                f[i] = 1, used++;
+        using Node = std::pair<unsigned long long, int>;
+        std::array<Node, N> heap;
+        std::array<int, 2 * N> parent, depth;
+        for (;;) {
+            int size = 0, next = N;
+            for (size_t i = 0; i < N; i++)
+                if (f[i])
+                    heap[size++] = {f[i], int(i)};
+            std::make_heap(heap.begin(), heap.begin() + size, std::greater<>());
+            for (; size > 1; next++) {
+                std::pop_heap(heap.begin(), heap.begin() + size--,
+                              std::greater<>());
+                std::pop_heap(heap.begin(), heap.begin() + size,
+                              std::greater<>());
+                Node &a = heap[size], &b = heap[size - 1];
+                parent[a.second] = parent[b.second] = next;
+                b = {a.first + b.first, next};
+                std::push_heap(heap.begin(), heap.begin() + size,
+                               std::greater<>());
             }
-            is_flower.at(node) = 1;
-            nodes.push_back(node);
+            // Internal nodes are made in order, so a parent comes after its
+            // children, and the root is the last one.
+            depth[next - 1] = 0;
+            for (int i = next - 2; i >= 0; i--)
+                if (i >= int(N) || f[i])
+                    depth[i] = depth[parent[i]] + 1;
+            int deepest = 0;
+            for (size_t i = 0; i < N; i++)
+                len[i] = f[i] ? depth[i] : 0,
+                deepest = std::max<int>(deepest, len[i]);
+            if (deepest <= limit)
+                return;
+            for (auto& x : f)
+                x = (x + 1) / 2;
         }
-        for (int i = 2; i <= size; i++)
-            if (is_flower.at(i))
-                fa.at(i) = 1;
-            else
-                fa.at(i) = rnd.any(nodes);
-        return *this;
     }
     /**
-     *  @brief  Generate a tree with chain size is about chain_percent * size
-     * and flower size is about flower_percent * size.
-     *  @param  size The count of the nodes that will be generated
-     *  @param  chain_percent the percent of the chain size.
-     *  @param  flower_percent the percent of the flower size.
-     *  @return The graph itself.
-     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1,
-     * or chain_percent + flower_percent > 1.
+     *  @brief  The canonical codes of the lengths `len`, bit-reversed.
      */
-    inline _Self chain_and_flower(int size,
-                                  double chain_percent = 0.3,
-                                  double flower_percent = 0.3) {
-        ensure(chain_percent + flower_percent <= 1);
-        init(size);
-        int i = 2;
-        for (; i < size * chain_percent; i++)
-            fa.at(i) = i - 1;
-        int tmp = i - 1;
-        for (; i < size * (chain_percent + flower_percent); i++)
-            fa.at(i) = tmp;
-        for (; i <= size; i++)
-            fa.at(i) = rnd.next(1, i - 1);
-        return *this;
+    template <size_t N>
+    static void canonical(const std::array<unsigned char, N>& len,
+                          std::array<unsigned short, N>& code) {
+        int count[16] = {}, next[16] = {};
+        for (int l : len)
+            count[l]++;
+        count[0] = 0;
+        for (int l = 1; l < 16; l++)
+            next[l] = (next[l - 1] + count[l - 1]) << 1;
+        for (size_t i = 0; i < N; i++) {
+            unsigned c = next[len[i]]++, r = 0;
+            for (int k = 0; k < len[i]; k++)
+                r |= (c >> k & 1) << (len[i] - 1 - k);
+            code[i] = r;
+        }
     }
     /**
-     *  @brief  Generate a tree with random shape, that is to say, randomly
-     * chose from the methods above.
-     *  @param  size The count of the nodes that will be generated.
-     *  @return The graph itself.
-     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
+     *  @brief  Write the tokens as one non-final block, of the smallest type.
+     *  @param  raw, size the input of the block, stored as is if it is the
+     * smallest.
      */
-    inline _Self random_shaped_tree(int size) {
-        int idx = rnd.next(6);
-        if (idx == 0)
-            sqrt_height_tree(size);
-        if (idx == 1)
-            log_height_tree(size);
-        if (idx == 2)
-            chain(size);
-        if (idx == 3)
-            flower(size);
-        if (idx == 4)
-            n_deg_tree(size);
-        if (idx == 5) {
-            double cp = rnd.wnext(1.0, 2), fp = rnd.next(1.0 - cp);
-            chain_and_flower(size, cp, fp);
+    inline void block(const char* raw, size_t size) {
+        // The bits of the block of each type. The extra bits of lengths and
+        // distances are the same in both coded types.
+        unsigned long long extra = 0, fixed = 3, dynamic = 3 + 14;
+        huffman(lfreq, 15, llen), huffman(dfreq, 15, dlen);
+        for (int s = 0; s < 286; s++) {
+            fixed += 1ull * lfreq[s] * _fixed_length(s);
+            dynamic += 1ull * lfreq[s] * llen[s];
+            extra += s > 256 ? 1ull * lfreq[s] * lextra(s - 257) : 0;
+        }
+        for (int d = 0; d < 30; d++) {
+            fixed += 5ull * dfreq[d];
+            dynamic += 1ull * dfreq[d] * dlen[d];
+            extra += 1ull * dfreq[d] * dextra(d);
+        }
+        // The code lengths, compressed by the symbols 16, 17 and 18.
+        int hlit = 286, hdist = 30, hclen = 19;
+        while (hlit > 257 && !llen[hlit - 1])
+            hlit--;
+        while (hdist > 1 && !dlen[hdist - 1])
+            hdist--;
+        std::array<int, 286 + 30> lens;
+        std::copy(llen.begin(), llen.begin() + hlit, lens.begin());
+        std::copy(dlen.begin(), dlen.begin() + hdist, lens.begin() + hlit);
+        rle.clear();
+        for (int i = 0, j; i < hlit + hdist; i = j) {
+            for (j = i; j < hlit + hdist && lens[j] == lens[i];)
+                j++;
+            int run = j - i;
+            if (!lens[i]) {
+                for (; run >= 11; run -= std::min(run, 138))
+                    rle.push_back({18, std::min(run, 138) - 11});
+                if (run >= 3)
+                    rle.push_back({17, run - 3}), run = 0;
+            } else {
+                rle.push_back({lens[i], 0}), run--;
+                for (; run >= 3; run -= std::min(run, 6))
+                    rle.push_back({16, std::min(run, 6) - 3});
+            }
+            for (; run > 0; run--)
+                rle.push_back({lens[i], 0});
+        }
+        static const int order[19] = {16, 17, 18, 0, 8,  7, 9,  6, 10, 5,
+                                      11, 4,  12, 3, 13, 2, 14, 1, 15};
+        std::array<unsigned, 19> cfreq{};
+        std::array<unsigned char, 19> clen;
+        std::array<unsigned short, 19> ccode;
+        for (auto [sym, x] : rle)
+            cfreq[sym]++;
+        huffman(cfreq, 7, clen), canonical(clen, ccode);
+        while (hclen > 4 && !clen[order[hclen - 1]])
+            hclen--;
+        dynamic += 3 * hclen;
+        for (int sym = 0; sym < 19; sym++)
+            dynamic += 1ull * cfreq[sym] * (clen[sym] + _rle_extra(sym));
+        unsigned long long stored =
+            (size + 65534) / 65535 * (3 + 7 + 32) + 8 * size;
+        if (stored < std::min(fixed, dynamic) + extra) {
+            for (size_t off = 0; off < size;) {
+                unsigned k = std::min<size_t>(65535, size - off);
+                bits(0, 3);
+                for (bits(0, (8 - bitcnt % 8) % 8); bitcnt; bitcnt -= 8)
+                    out.push_back(char(bitbuf & 255)), bitbuf >>= 8;
+                for (unsigned v : {k, ~k & 65535})
+                    out.push_back(char(v & 255)), out.push_back(char(v >> 8));
+                out.append(raw + off, k), off += k;
+            }
+            return;
+        }
+        if (dynamic < fixed) {
+            bits(0, 1), bits(2, 2);
+            bits(hlit - 257, 5), bits(hdist - 1, 5), bits(hclen - 4, 4);
+            for (int i = 0; i < hclen; i++)
+                bits(clen[order[i]], 3);
+            for (auto [sym, x] : rle) {
+                bits(ccode[sym], clen[sym]);
+                if (sym >= 16)
+                    bits(x, _rle_extra(sym));
+            }
+            canonical(llen, lcode), canonical(dlen, dcode);
+        } else {
+            // Not `canonical()`: the fixed code counts 288 symbols.
+            static const auto codes = [] {
+                std::array<unsigned short, 286> res{};
+                for (int s = 0; s < 286; s++) {
+                    int code = s < 144   ? 0x30 + s
+                               : s < 256 ? 0x190 + s - 144
+                               : s < 280 ? s - 256
+                                         : 0xc0 + s - 280;
+                    for (int i = 0, len = _fixed_length(s); i < len; i++)
+                        res[s] |= (code >> i & 1) << (len - 1 - i);
+                }
+                return res;
+            }();
+            bits(0, 1), bits(1, 2);
+            for (int s = 0; s < 286; s++)
+                llen[s] = _fixed_length(s);
+            lcode = codes, dlen.fill(5), canonical(dlen, dcode);
+        }
+        for (unsigned t : tokens) {
+            if (t < 256) {
+                bits(lcode[t], llen[t]);
+                continue;
+            }
+            int len = t & 511, dist = t >> 9;
+            auto [l, d] = symbols(len, dist);
+            bits(lcode[257 + l], llen[257 + l]);
+            if (lextra(l))
+                bits(len - lbase[l], lextra(l));
+            bits(dcode[d], dlen[d]);
+            if (dextra(d))
+                bits(dist - dbase[d], dextra(d));
         }
+        bits(lcode[256], llen[256]);
+    }
+};
+
+/**
+ *  @brief  The formats that `Output` can write.
+ */
+enum class OutputMode {
+    text,    ///< The canonical decimal text.
+    binary,  ///< Varint records that `render_binary()` expands to the text.
+};
+
+/**
+ *  @brief  The output layer of CPgen. Every `print` method writes through
+ * `_out`, which is the decimal text on stdout by default.
+ *
+ * The binary format starts with `CPGB\1`, followed by records:
+ * - `0` text: varint length, then the raw bytes.
+ * - `1` line: varint count, then zigzag varints, separated by spaces.
+ * - `2` sequence: sep byte, end byte, varint count, then zigzag varints.
+ *   Every value is followed by sep, and the end byte comes last.
+ * - `3` sorted sequence: as `2`, but the values after the first one are
+ *   stored as unsigned varint deltas.
+ * - `4` edges: weighted flag byte, varint count, then for each edge the
+ *   zigzag deltas \f$u-u_{prev}\f$ and \f$v-u\f$, and the zigzag weight.
+ *
+ * When the binary format or gzip is used, route ALL the output through
+ * `_out` (e.g. `_out.println(n, m)`), as `println` of testlib and
+ * `std::cout` still write text to stdout.
+ */
+class Output {
+   public:
+    using _Self = Output;
+    OutputMode mode = OutputMode::text;  ///< The format being written.
+    bool gzip = false;  ///< Denoting if the output is compressed by gzip.
+
+    ~Output() { close(); }
+    /**
+     *  @brief  Redirect the output to `path`.
+     *  @param  path the file to be written, or `nullptr` for stdout.
+     *  @param  output_mode the format to be written.
+     *  @param  compressed if the output should be compressed by gzip.
+     *  @return The output itself.
+     *  @throw  Throws GenException when the file can not be opened.
+     */
+    inline _Self& open(const char* path,
+                       OutputMode output_mode = OutputMode::text,
+                       bool compressed = false) {
+        std::FILE* f = path ? std::fopen(path, "wb") : stdout;
+        if (!f)
+            throw GenException(
+                format("Can not open the output file: %s", path));
+        attach(f, output_mode, compressed);
+        owned = path != nullptr;
         return *this;
     }
     /**
-     *  @brief  Output the generated edges to stdout. NOTE that n will not be
-     * printed.
-     *  @param  weights the weights of the edges. Input weights[i] as the weight
-     * of the edge [fa[i], i].
-     *  @param  shuffled if I should print it in random order.
-     *  @return The graph itself.
-     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
+     *  @brief  Redirect the output to an opened file, which will not be
+     * closed by `Output`.
      */
-    inline _Self print(int shuffled,
-                       std::vector<int> weights = std::vector<int>{}) {
-        bool output_weight = true;
-        if (weights.size() == 0)
-            output_weight = false;
-        else if (int(weights.size()) != n + 1)
-            Quit("Invalid weights.size(): ", weights.size());
-        std::vector<int> order(n + 1);
-        std::iota(order.begin(), order.end(), 0);
-        if (shuffled)
-            order = _rnd.shuffle(order);
-        for (int i = 2; i <= n; i++)
-            if (output_weight)
-                println(order.at(i), fa.at(order.at(i)), weights.at(i));
-            else
-                println(order.at(i), fa.at(order.at(i)));
+    inline _Self& attach(std::FILE* f,
+                         OutputMode output_mode = OutputMode::text,
+                         bool compressed = false) {
+        close();
+        file = f, mode = output_mode, gzip = compressed;
+        if (gzip)
+            zip.begin();
+        if (mode == OutputMode::binary)
+            put("CPGB\1", 5);
         return *this;
     }
     /**
-     *  @brief  Output the generated `fa` array to stdout. NOTE that n will not
-     * be printed.
-     *  @param sep The seperator.
-     *  @param end the end char.
-     *  @param  shuffled if I should print it in random order.
-     *  @return The graph itself.
-     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
+     *  @brief  Flush everything and finish the gzip stream, then go back to
+     * the text on stdout.
+     */
+    inline void close() {
+        flush();
+        if (gzip)
+            zip.finish(), drain();
+        owned ? void(std::fclose(file)) : void(std::fflush(file));
+        file = stdout, mode = OutputMode::text, gzip = owned = false;
+    }
+    /**
+     *  @brief  Print the values separated by spaces and end the line, like
+     * `println` of testlib.
+     *  @param  params Any. Anything that can be printed, with any number.
+     *  @return The output itself.
+     */
+    template <typename... Args>
+    inline _Self& println(const Args&... params) {
+        if constexpr ((_is_number<Args>::value && ...)) {
+            if (mode == OutputMode::binary) {
+                put(char(1)), varint(sizeof...(Args));
+                (zigzag(i64_ll(params)), ...);
+                return commit();
+            }
+        }
+        framed([&]() {
+            int cnt = 0;
+            ((cnt++ ? text(' ') : void(), text(params)), ...);
+            text('\n');
+        });
+        return commit();
+    }
+    /**
+     *  @brief  Print the values in \f$[first, last)\f$, each one followed by
+     * `sep`, then print `end`.
+     *  @return The output itself.
+     */
+    template <typename _It>
+    inline _Self& write_seq(_It first,
+                            _It last,
+                            char sep = ' ',
+                            char end = '\n') {
+        using _Tp = typename std::iterator_traits<_It>::value_type;
+        if constexpr (_is_number<_Tp>::value) {
+            if (mode == OutputMode::binary) {
+                bool sorted = std::is_sorted(first, last);
+                put(char(sorted ? 3 : 2)), put(sep), put(end);
+                varint(std::distance(first, last));
+                i64_ll prev = 0;
+                for (_It it = first; it != last; ++it) {
+                    if (sorted && it != first)
+                        varint(i64_ll(*it) - prev);
+                    else
+                        zigzag(*it);
+                    prev = *it;
+                }
+                return commit();
+            }
+        }
+        framed([&]() {
+            for (; first != last; ++first) {
+                text(*first), text(sep);
+                if (mode == OutputMode::text && buf.size() >= chunk)
+                    flush();
+            }
+            text(end);
+        });
+        return commit();
+    }
+    /**
+     *  @brief  Print `count` edges, one edge per line.
+     *  @param  get a function that returns the \f$u, v, w\f$ of the i-th
+     * edge as `std::array<i64_ll, 3>`.
+     *  @return The output itself.
+     */
+    template <typename _Func>
+    inline _Self& write_edges(size_t count, bool weighted, _Func get) {
+        if (mode == OutputMode::binary) {
+            put(char(4)), put(char(weighted)), varint(count);
+            i64_ll prev = 0;
+            for (size_t i = 0; i < count; i++) {
+                std::array<i64_ll, 3> e = get(i);
+                zigzag(e[0] - prev), zigzag(e[1] - e[0]), prev = e[0];
+                if (weighted)
+                    zigzag(e[2]);
+            }
+            return commit();
+        }
+        for (size_t i = 0; i < count; i++) {
+            std::array<i64_ll, 3> e = get(i);
+            number(e[0]), text(' '), number(e[1]);
+            if (weighted)
+                text(' '), number(e[2]);
+            text('\n');
+            if (buf.size() >= chunk)
+                flush();
+        }
+        return commit();
+    }
+    /**
+     *  @brief  Print `get(0)`, ..., `get(count - 1)` like `write_seq`, but
+     * formatted by `threads` threads (by default one per core). See
+     * `_parallel()`. `get` is called from all the threads.
+     *  @return The output itself.
+     */
+    template <typename _Func>
+    inline _Self& write_seq_parallel(size_t count,
+                                     _Func get,
+                                     char sep = ' ',
+                                     char end = '\n',
+                                     int threads = 0) {
+        auto format = [&](Output& w, size_t first, size_t last) {
+            for (size_t i = first; i < last; i++)
+                w.text(get(i)), w.text(sep);
+            if (last == count)
+                w.text(end);
+        };
+        if (_parallel(count, format, threads))
+            return commit();
+        return write_seq(_Indexed<_Func>{&get, 0},
+                         _Indexed<_Func>{&get, count}, sep, end);
+    }
+    /**
+     *  @brief  Print `count` edges like `write_edges`, but formatted by
+     * `threads` threads (by default one per core). See `_parallel()`. `get`
+     * is called from all the threads.
+     *  @return The output itself.
+     */
+    template <typename _Func>
+    inline _Self& write_edges_parallel(size_t count,
+                                       bool weighted,
+                                       _Func get,
+                                       int threads = 0) {
+        auto format = [&](Output& w, size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) {
+                std::array<i64_ll, 3> e = get(i);
+                w.number(e[0]), w.put(' '), w.number(e[1]);
+                if (weighted)
+                    w.put(' '), w.number(e[2]);
+                w.put('\n');
+            }
+        };
+        if (_parallel(count, format, threads))
+            return commit();
+        return write_edges(count, weighted, get);
+    }
+    /**
+     *  @brief  Keep the text on stdout in the buffer until `release()`,
+     * instead of flushing it at the end of every print. Do not use
+     * `std::cout` in between. The calls can be nested.
+     */
+    inline void hold() { held++; }
+    /**
+     *  @brief  Undo a `hold()`.
+     */
+    inline void release() {
+        if (held && !--held)
+            commit();
+    }
+    /**
+     *  @brief  Write the buffer to the file.
+     */
+    inline void flush() {
+        if (gzip)
+            zip.feed(buf.data(), buf.size()), drain();
+        else if (!buf.empty())
+            std::fwrite(buf.data(), 1, buf.size(), file);
+        buf.clear();
+    }
+
+   private:
+    friend void render_binary(std::FILE*, std::FILE*);
+    template <typename _Tp>
+    using _is_number = std::integral_constant<
+        bool, std::is_integral<_Tp>::value &&
+                  (sizeof(_Tp) < 8 || std::is_signed<_Tp>::value) &&
+                  !std::is_same<_Tp, char>::value &&
+                  !std::is_same<_Tp, signed char>::value &&
+                  !std::is_same<_Tp, unsigned char>::value>;
+    static const size_t chunk = 1 << 16;
+    std::FILE* file = stdout;
+    bool owned = false;
+    int held = 0;  ///< The count of the `hold()`s not released yet.
+    std::string buf;
+    _Gzip zip;
+    /**
+     *  @brief  `get(i)` as a forward iterator, for the serial fallback of
+     * `write_seq_parallel()`.
+     */
+    template <typename _Func>
+    struct _Indexed {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::decay_t<decltype(std::declval<_Func&>()(0))>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+        _Func* get;
+        size_t idx;
+        inline value_type operator*() const { return (*get)(idx); }
+        inline _Indexed& operator++() { return ++idx, *this; }
+        inline bool operator==(const _Indexed& rhs) const {
+            return idx == rhs.idx;
+        }
+        inline bool operator!=(const _Indexed& rhs) const {
+            return idx != rhs.idx;
+        }
+    };
+    /**
+     *  @brief  Split \f$[0, count)\f$ into chunks, and let `threads`
+     * threads format them by `format(w, first, last)` into their own
+     * buffers `w`. The chunks are written in order: a regular file gets
+     * each of them by `pwrite` at its offset as soon as the earlier chunks
+     * are formatted, so the writes are parallel too; a pipe or a terminal
+     * gets each of them as soon as the earlier ones are written.
+     *  @return If it is done, or the caller should print serially, for the
+     * binary format, gzip, one thread or a system without POSIX.
      */
-    inline _Self print_fa(char sep = ' ', char end = '\n') {
-        for (int i = 2; i <= n; i++)
-            std::cout << fa[i] << sep;
-        std::cout << end;
+    template <typename _Func>
+    inline bool _parallel(size_t count, _Func format, int threads) {
+#ifdef __unix__
+        const size_t grain = 1 << 14;
+        size_t chunks = (count + grain - 1) / grain;
+        if (threads <= 0)
+            threads = std::thread::hardware_concurrency();
+        threads = std::min<size_t>(threads, chunks);
+        if (threads <= 1 || mode != OutputMode::text || gzip)
+            return false;
+        flush(), std::fflush(file);
+        int fd = fileno(file);
+        struct stat st;
+        off_t offset = -1;
+        if (!fstat(fd, &st) && S_ISREG(st.st_mode) &&
+            !(fcntl(fd, F_GETFL) & O_APPEND))
+            offset = lseek(fd, 0, SEEK_CUR);
+        bool seekable = offset >= 0;
+        std::mutex lock;
+        std::condition_variable done;
+        size_t next = 0, turn = 0;  ///< The chunk to format, and to write.
+        auto work = [&]() {
+            Output w;
+            for (;;) {
+                std::unique_lock<std::mutex> guard(lock);
+                size_t c = next++;
+                if (c >= chunks)
+                    break;
+                guard.unlock();
+                w.buf.clear();
+                format(w, c * grain, std::min(count, (c + 1) * grain));
+                guard.lock();
+                done.wait(guard, [&]() { return turn == c; });
+                off_t at = offset;
+                if (seekable)
+                    offset += w.buf.size(), turn++, guard.unlock();
+                else
+                    _write_all(fd, w.buf, -1), turn++, guard.unlock();
+                done.notify_all();
+                if (seekable)
+                    _write_all(fd, w.buf, at);
+            }
+            w.buf.clear();
+        };
+        std::vector<std::thread> pool;
+        for (int t = 1; t < threads; t++)
+            pool.emplace_back(work);
+        work();
+        for (std::thread& t : pool)
+            t.join();
+        if (seekable)
+            fseeko(file, offset, SEEK_SET);
+        return true;
+#else
+        return false;
+#endif
+    }
+#ifdef __unix__
+    /**
+     *  @brief  Write all of `s` to `fd`, at `at` by `pwrite` if it is not
+     * \f$-1\f$.
+     */
+    static inline void _write_all(int fd, const std::string& s, off_t at) {
+        for (size_t done = 0; done < s.size();) {
+            ssize_t k = at >= 0 ? pwrite(fd, s.data() + done, s.size() - done,
+                                         at + done)
+                                : write(fd, s.data() + done, s.size() - done);
+            if (k < 0 && errno == EINTR)
+                continue;
+            if (k <= 0)
+                return;
+            done += k;
+        }
+    }
+#endif
+    /**
+     *  @brief  End a print. The text on stdout is flushed at once, so that it
+     * keeps its order with `std::cout`.
+     */
+    inline _Self& commit() {
+        bool ordered =
+            !held && file == stdout && !gzip && mode == OutputMode::text;
+        if (buf.size() >= (ordered ? 0 : gzip ? chunk << 4 : chunk))
+            flush();
         return *this;
     }
+    inline void drain() {
+        std::fwrite(zip.out.data(), 1, zip.out.size(), file);
+        zip.out.clear();
+    }
+    inline void put(const char* s, size_t len) {
+        buf.append(s, len), CPGEN_PROFILE_COUNT(written, len);
+    }
+    inline void put(char c) {
+        buf.push_back(c), CPGEN_PROFILE_COUNT(written, 1);
+    }
+    inline void varint(unsigned long long v) {
+        for (; v >= 128; v >>= 7)
+            put(char(v | 128));
+        put(char(v));
+    }
+    inline void zigzag(i64_ll v) {
+        varint((unsigned long long)v << 1 ^ (unsigned long long)(v >> 63));
+    }
+    inline void number(i64_ll v) {
+        char tmp[24];
+        int len = 0;
+        unsigned long long u = v < 0 ? 0ull - v : v;
+        do
+            tmp[len++] = '0' + u % 10;
+        while (u /= 10);
+        if (v < 0)
+            put('-');
+        while (len)
+            put(tmp[--len]);
+    }
     /**
-     *  @brief  Get the leave nodes of the current tree.
-     *  @return The leaves.
-     *  @throw  It throws what `std::vector<int>` throws.
+     *  @brief  Append the text form of any value. Values that are not
+     * integers or strings are formatted like `std::cout` does.
      */
-    inline std::vector<int> get_leaves() {
-        std::vector<int> is_leave(n + 1, 1);
-        for (int i = 1; i <= n; i++)
-            is_leave.at(fa.at(i)) = 0;
-        leaves.clear();
-        for (int i = 1; i <= n; i++)
-            if (is_leave.at(i))
-                leaves.push_back(i);
-        return leaves;
+    template <typename _Tp>
+    inline void text(const _Tp& v) {
+        if constexpr (_is_number<_Tp>::value) {
+            number(v);
+        } else if constexpr (std::is_same<_Tp, char>::value) {
+            put(v);
+        } else if constexpr (std::is_convertible<const _Tp&,
+                                                 std::string_view>::value) {
+            std::string_view s = v;
+            put(s.data(), s.size());
+        } else {
+            std::ostringstream os;
+            os.copyfmt(std::cout);
+            os << v;
+            std::string s = os.str();
+            put(s.data(), s.size());
+        }
     }
-};
+    /**
+     *  @brief  Run `write`, which appends text. In the binary format, the
+     * text is wrapped into a text record.
+     */
+    template <typename _Func>
+    inline void framed(_Func write) {
+        if (mode != OutputMode::binary)
+            return write();
+        std::string saved, res;
+        saved.swap(buf), write(), res.swap(buf), buf.swap(saved);
+        put(char(0)), varint(res.size()), put(res.data(), res.size());
+    }
+} _out;
 
 /**
- *  @brief  Class that used to generate an array.
+ *  @brief  Expand the binary format of `Output` to the canonical text, e.g.
+ * `int main() { render_binary(stdin, stdout); }` gives a renderer. Pipe the
+ * file through `gzip -d` first if it is compressed.
+ *  @param  in the binary file.
+ *  @param  out where the text is written.
+ *  @return no return.
+ *  @throw  Throws GenException when `in` is not a valid binary file.
  */
-template <typename _Tp>
-class Array {
+inline void render_binary(std::FILE* in, std::FILE* out) {
+    auto byte = [&]() {
+        int c = std::fgetc(in);
+        if (c == EOF)
+            throw GenException("Unexpected end of the binary file.");
+        return char(c);
+    };
+    auto varint = [&]() {
+        unsigned long long v = 0;
+        for (int shift = 0;; shift += 7) {
+            unsigned char c = byte();
+            v |= (unsigned long long)(c & 127) << shift;
+            if (c < 128)
+                return v;
+        }
+    };
+    auto zigzag = [&]() {
+        unsigned long long v = varint();
+        return i64_ll(v >> 1) ^ -i64_ll(v & 1);
+    };
+    char magic[5];
+    if (std::fread(magic, 1, 5, in) != 5 || std::memcmp(magic, "CPGB\1", 5))
+        throw GenException("Not a binary file of CPgen.");
+    Output res;
+    res.attach(out);
+    for (int tag; (tag = std::fgetc(in)) != EOF;) {
+        if (tag == 0) {
+            size_t len = varint();
+            for (size_t i = 0; i < len; i++)
+                res.put(byte());
+        } else if (tag == 1) {
+            size_t cnt = varint();
+            for (size_t i = 0; i < cnt; i++)
+                i ? res.put(' ') : void(), res.number(zigzag());
+            res.put('\n');
+        } else if (tag == 2 || tag == 3) {
+            char sep = byte(), end = byte();
+            size_t cnt = varint();
+            i64_ll prev = 0;
+            for (size_t i = 0; i < cnt; i++) {
+                prev = tag == 3 && i ? prev + i64_ll(varint()) : zigzag();
+                res.number(prev), res.put(sep);
+            }
+            res.put(end);
+        } else if (tag == 4) {
+            bool weighted = byte();
+            size_t cnt = varint();
+            i64_ll u = 0;
+            for (size_t i = 0; i < cnt; i++) {
+                u += zigzag();
+                res.number(u), res.put(' '), res.number(u + zigzag());
+                if (weighted)
+                    res.put(' '), res.number(zigzag());
+                res.put('\n');
+            }
+        } else {
+            throw GenException(
+                format("Unknown record in the binary file: %d", tag));
+        }
+        if (res.buf.size() >= Output::chunk)
+            res.flush();
+    }
+    res.close();
+}
+
+#ifdef __linux__
+#include <dirent.h>
+#include <sys/sendfile.h>
+#include <sys/mman.h>
+#include <algorithm>
+#include <ctime>
+#include <tuple>
+
+/**
+ *  @brief  A local cache of the outputs of the generator. As `registerGen`
+ * makes the output a function of the binary and argv, the stdout of a run is
+ * stored under a hash of (the bytes of the binary, argv), and the next run
+ * with the same key sends the stored file to stdout by `sendfile` and exits
+ * without generating anything:
+ * ```
+ * int main(int argc, char** argv) {
+ *     registerGen(argc, argv, 1);
+ *     _cache.use(argc, argv);
+ *     ...
+ * }
+ * ```
+ * The entries live in `$CPGEN_CACHE_DIR` (default as `.cpgen_cache`, an
+ * empty value disables the cache), and the least recently used ones are
+ * removed when they take more than `max_bytes`. Only stdout is cached, and
+ * a run is stored only if it exits with \f$0\f$. Linux only.
+ */
+class TestCache {
    public:
-    using _Sequence = std::vector<_Tp>;
-    using _Self = Array<_Tp>;
-    int n;            ///< size of the array that generated.
-    _Sequence array;  ///< The container of the elements.
+    size_t max_bytes = size_t(1) << 30;  ///< The sup of the cache size.
     /**
-     *  @brief  return the reference of the size-th element in this array.
-     *  @param  idx the index of the element you requested.
-     *  @return The reference of the element.
-     *  @throw  out_of_range if idx is an invalid index.
+     *  @brief  On a hit, write the stored output and exit with \f$0\f$.
+     * Otherwise capture stdout, which is forwarded and stored at exit. Call
+     * it before anything is printed.
+     *  @param  argc, argv the arguments of `main`.
+     *  @return no return.
      */
-    inline _Tp& operator[](int idx) {
-        ensure(idx <= n);
-        return array.at(idx);
+    inline void use(int argc, char** argv) {
+        const char* env = std::getenv("CPGEN_CACHE_DIR");
+        _dir = env ? env : ".cpgen_cache";
+        if (_saved >= 0 || _dir.empty() ||
+            (mkdir(_dir.c_str(), 0755) && errno != EEXIST))
+            return;
+        std::string key = _key(argc, argv);
+        if (key.empty())
+            return;
+        _path = _dir + "/" + key + ".out";
+        int fd = ::open(_path.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            futimens(fd, nullptr);  // Mark it as recently used.
+            bool ok = _send(fd, STDOUT_FILENO);
+            ::close(fd);
+            std::exit(ok ? 0 : 1);
+        }
+        _tmp = _path + "." + std::to_string(getpid()) + ".tmp";
+        fd = ::open(_tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            return;
+        std::cout.flush(), std::fflush(stdout);
+        if ((_saved = dup(STDOUT_FILENO)) < 0 ||
+            dup2(fd, STDOUT_FILENO) < 0) {
+            _saved >= 0 ? void(::close(_saved)) : void();
+            _saved = -1, ::close(fd), unlink(_tmp.c_str());
+            return;
+        }
+        ::close(fd), on_exit(_finish, this);
     }
+
+   private:
+    std::string _dir, _path, _tmp;
+    int _saved = -1;  ///< The real stdout while capturing.
     /**
-     *  @brief  return the reference of the first element in this array.
-     *  @return The reference of the element.
-     *  @throw  It throws what the _Sequence throws.
+     *  @brief  Give stdout back, forward the captured output to it, and
+     * store the output if the generator succeeded.
      */
-    inline auto begin() { return array.begin(); }
+    static void _finish(int status, void* arg) {
+        TestCache& c = *static_cast<TestCache*>(arg);
+        _out.close(), std::cout.flush(), std::fflush(stdout);
+        int fd = dup(STDOUT_FILENO);
+        dup2(c._saved, STDOUT_FILENO), ::close(c._saved), c._saved = -1;
+        if (fd < 0)
+            return void(unlink(c._tmp.c_str()));
+        _send(fd, STDOUT_FILENO), ::close(fd);
+        if (status == 0 && !rename(c._tmp.c_str(), c._path.c_str()))
+            c._evict();
+        else
+            unlink(c._tmp.c_str());
+    }
     /**
-     *  @brief  return the reference of the last element in this array.
-     *  @return The reference of the element.
-     *  @throw  It throws what the _Sequence throws.
+     *  @brief  Write the whole file `in` to `out` without copying it to the
+     * user space, or by `mmap` and `write` if `sendfile` can not.
+     *  @return If everything is written.
      */
-    inline auto end() { return array.end(); }
+    static inline bool _send(int in, int out) {
+        struct stat st;
+        if (fstat(in, &st))
+            return false;
+        off_t off = 0;
+        while (off < st.st_size) {
+            ssize_t k = sendfile(out, in, &off, st.st_size - off);
+            if (k <= 0 && !(k < 0 && errno == EINTR))
+                break;
+        }
+        if (off >= st.st_size)
+            return true;
+        void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, in, 0);
+        if (map == MAP_FAILED)
+            return false;
+        const char* data = static_cast<const char*>(map);
+        while (off < st.st_size) {
+            ssize_t k = write(out, data + off, st.st_size - off);
+            if (k < 0 && errno == EINTR)
+                continue;
+            if (k <= 0)
+                break;
+            off += k;
+        }
+        munmap(map, st.st_size);
+        return off >= st.st_size;
+    }
     /**
-     *  @brief  init the whole array with the size of `size`.
-     *  @param  size how large this array should be.
-     *  @return no return.
-     *  @throw  It throws what the _Sequence throws.
+     *  @brief  A hash of the bytes of the binary and the arguments after
+     * `argv[0]`. The binary is mapped once and read 8 bytes at a time, so a
+     * rebuild to the same bytes keeps the entries, and any other change
+     * misses even if the size and the mtime are kept.
+     *  @return The key in hex, or empty if the binary can not be read.
+     */
+    static inline std::string _key(int argc, char** argv) {
+        int fd = ::open("/proc/self/exe", O_RDONLY);
+        if (fd < 0)
+            return "";
+        struct stat st;
+        void* map = MAP_FAILED;
+        if (!fstat(fd, &st) && st.st_size > 0)
+            map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED)
+            return "";
+        unsigned long long h = _mix64(st.st_size);
+        const char* data = static_cast<const char*>(map);
+        size_t size = st.st_size, i = 0;
+        for (unsigned long long w; i + 8 <= size; i += 8)
+            std::memcpy(&w, data + i, 8), h = _mix64(h ^ w);
+        for (; i < size; i++)
+            h = _mix64(h ^ static_cast<unsigned char>(data[i]));
+        munmap(map, st.st_size);
+        for (int k = 1; k < argc; k++)
+            for (const char* p = argv[k];; p++) {
+                h = _mix64(h ^ static_cast<unsigned char>(*p));
+                if (!*p)
+                    break;
+            }
+        char hex[17];
+        std::snprintf(hex, sizeof(hex), "%016llx", h);
+        return hex;
+    }
+    /**
+     *  @brief  Remove the least recently used entries until they fit in
+     * `max_bytes`, and the captures left by the runs that were killed.
+     */
+    inline void _evict() {
+        DIR* d = opendir(_dir.c_str());
+        if (!d)
+            return;
+        std::vector<std::tuple<long long, size_t, std::string>> entries;
+        size_t total = 0;
+        long long now = std::time(nullptr);
+        while (dirent* e = readdir(d)) {
+            std::string name = e->d_name, path = _dir + "/" + name;
+            struct stat st;
+            if (stat(path.c_str(), &st) || !S_ISREG(st.st_mode))
+                continue;
+            auto ends_with = [&](const char* s) {
+                size_t k = std::strlen(s);
+                return name.size() > k && !name.compare(name.size() - k, k, s);
+            };
+            if (ends_with(".tmp") && now - st.st_mtim.tv_sec > 86400)
+                unlink(path.c_str());
+            else if (ends_with(".out"))
+                entries.emplace_back(st.st_mtim.tv_sec * 1000000000ll +
+                                         st.st_mtim.tv_nsec,
+                                     st.st_size, path),
+                    total += st.st_size;
+        }
+        closedir(d);
+        std::sort(entries.begin(), entries.end());
+        for (auto& [mtime, size, path] : entries) {
+            if (total <= max_bytes)
+                break;
+            if (!unlink(path.c_str()))
+                total -= size;
+        }
+    }
+} _cache;
+#endif
+
+/**
+ *  @brief print a vector.
+ *  @param vec Any std::vector<_Tp>.
+ *  @param sep The seperator.
+ *  @param end the end char.
+ *  @return no return.
+ *  @throw Throws exception when element is not print-able.
+ */
+template <typename T>
+inline void print(const std::vector<T>& vec, char sep = ' ', char end = '\n') {
+    _out.write_seq(vec.begin(), vec.end(), sep, end);
+}
+
+#define warn printf
+
+/**
+ *  @brief  Class that used to generate a tree.
+ */
+class Tree {
+   public:
+    int n;                    ///< The size of the tree.
+    std::vector<int> fa;      ///< `fa[i]` is the no. of node \f$i\f$'s father.
+    std::vector<int> leaves;  ///< The no. of leaves. NOTE that it would be
+                              ///< empty UNLESS you call `get_leaves()` method.
+    bool weighted = false;  ///< Denoting if the **edges** are weighted or not.
+    using _Self = Tree;
+    /**
+     *  @brief  Initiate Tree object with size `size`.
+     *  @param  size The count of the nodes that will be generated.
+     *  @return The graph itself.
+     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
      */
     inline void init(int size) {
+        fa.clear(), leaves.clear();
         if (size < 1)
             throw GenException(
                 format("Invalid 'n' has been passed in `init`: %d", size));
-        array.clear();
-        n = size, array.resize(n + 1);
+        n = size;
+        if (fa.capacity() < size_t(size) + 1)
+            CPGEN_PROFILE_COUNT(allocs, 1),
+                CPGEN_PROFILE_COUNT(alloc_bytes, (size + 1) * sizeof(int));
+        fa.resize(size + 1);
     }
     /**
-     *  @brief  Output the current array.
-     *  @return The array itself.
-     *  @throw  It throws what the _Sequence throws.
+     *  @brief  Generate a tree with an expected height of \f$O(\sqrt n)\f$
+     *  @param  size The count of the nodes that will be generated.
+     *  @return The graph itself.
+     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
      */
-    inline void print(char sep = ' ', char end = '\n') {
-        for (int i = 1; i <= n; i++)
-            std::cout << array.at(i) << sep;
-        std::cout << end;
+    inline _Self& sqrt_height_tree(int size) {
+        init(size);
+        auto p = _scratch<int>(size);
+        for (int i = 1; i <= size - 2; i++)
+            p.at(i) = rnd.next(1, size);
+        auto d = _scratch<int>(size + 1);
+        for (int i = 1; i <= size - 2; ++i)
+            d.at(p.at(i))++;
+        p.at(size - 1) = size;
+        for (int i = 1, j = 1; i < size; ++i, ++j) {
+            while (d.at(j))
+                ++j;
+            fa.at(j) = p.at(i);
+            while (i < n && !--d.at(p.at(i)) && p.at(i) < j)
+                fa.at(p.at(i)) = p.at(i + 1), ++i;
+        }
+        // The decoded tree is rooted at n, swap the labels of 1 and n.
+        for (int i = 1; i <= size; i++)
+            if (fa.at(i) == 1 || fa.at(i) == size)
+                fa.at(i) = 1 + size - fa.at(i);
+        std::swap(fa.at(1), fa.at(size));
+        return *this;
     }
     /**
-     *  @brief  Get the sum of the elements.
-     *  @return The sum of the elements.
-     *  @throw  It throws what the _Sequence throws.
+     *  @brief  Generate a tree with an expected height of \f$O(\log n)\f$
+     *  @param  size The count of the nodes that will be generated.
+     *  @return The graph itself.
+     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
      */
-    inline _Tp sum() {
-        _Tp current_sum = 0;
-        for (auto i : array)
-            current_sum += i;
-        return current_sum;
+    inline _Self& log_height_tree(int size) {
+        init(size);
+        for (int i = 2; i <= size; i++)
+            fa.at(i) = rnd.next(1, i - 1);
+        return *this;
     }
     /**
-     *  @brief  Generate an array with size `size`, while its elements are
-     * values in [wl, wr].
-     *  @param  size how large this array should be.
-     *  @param  wl the sub of the elements.
-     *  @param  wr the sup of the elements.
-     *  @return The array itself.
-     *  @throw  It throws what the _Sequence throws.
+     *  @brief  Generate a tree that is a chain.
+     *  @param  size The count of the nodes that will be generated.
+     *  @return The graph itself.
+     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
      */
-    inline _Self basic_gen(int size, _Tp wl, _Tp wr) {
+    inline _Self& chain(int size) {
         init(size);
-        for (int i = 1; i <= size; i++)
-            array.at(i) = rnd.next(wl, wr);
+        for (int i = 2; i <= size; i++)
+            fa.at(i) = i - 1;
         return *this;
     }
     /**
-     *  @brief  Sort the current array.
-     *  @throw  It throws what the _Sequence throws.
+     *  @brief  Generate a tree that is a flower.
+     *  @param  size The count of the nodes that will be generated.
+     *  @return The graph itself.
+     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
+     */
+    inline _Self& flower(int size) {
+        init(size);
+        for (int i = 2; i <= size; i++)
+            fa.at(i) = 1;
+        return *this;
+    }
+    /**
+     *  @brief  Generate a tree with an expected max_deg of \f$O(n)\f$.
+     *  @param  size The count of the nodes that will be generated.
+     *  @return The graph itself.
+     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
      */
-    inline void sort() { std::sort(array.begin(), array.end()); }
+    inline _Self& n_deg_tree(int size) {
+        CPGEN_PROFILE_SCOPE("Tree::n_deg_tree");
+        init(size);
+        int flowers_count = rnd.next(1, std::min(10, size));
+        auto is_flower = _scratch<int>(size + 1);
+        auto nodes = _scratch<int>();
+        for (int i = 1; i <= flowers_count; i++) {
+            int node = rnd.next(1, size);
+            CPGEN_PROFILE_COUNT(draws, 1);
+            if (is_flower.at(node) == 1) {
+                CPGEN_PROFILE_COUNT(rejects, 1);
+                i--;
+                continue;
+            }
+            is_flower.at(node) = 1;
+            nodes.push_back(node);
+        }
+        for (int i = 2; i <= size; i++)
+            if (is_flower.at(i))
+                fa.at(i) = 1;
+            else
+                fa.at(i) = rnd.any(nodes);
+        return *this;
+    }
+    /**
+     *  @brief  Generate a tree with chain size is about chain_percent * size
+     * and flower size is about flower_percent * size.
+     *  @param  size The count of the nodes that will be generated
+     *  @param  chain_percent the percent of the chain size.
+     *  @param  flower_percent the percent of the flower size.
+     *  @return The graph itself.
+     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1,
+     * or chain_percent + flower_percent > 1.
+     */
+    inline _Self& chain_and_flower(int size,
+                                   double chain_percent = 0.3,
+                                   double flower_percent = 0.3) {
+        ensure(chain_percent + flower_percent <= 1);
+        init(size);
+        int i = 2;
+        for (; i < size * chain_percent; i++)
+            fa.at(i) = i - 1;
+        int tmp = i - 1;
+        for (; i < size * (chain_percent + flower_percent); i++)
+            fa.at(i) = tmp;
+        for (; i <= size; i++)
+            fa.at(i) = rnd.next(1, i - 1);
+        return *this;
+    }
+    /**
+     *  @brief  Generate a tree with random shape, that is to say, randomly
+     * chose from the methods above.
+     *  @param  size The count of the nodes that will be generated.
+     *  @return The graph itself.
+     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
+     */
+    inline _Self& random_shaped_tree(int size) {
+        int idx = rnd.next(6);
+        if (idx == 0)
+            sqrt_height_tree(size);
+        if (idx == 1)
+            log_height_tree(size);
+        if (idx == 2)
+            chain(size);
+        if (idx == 3)
+            flower(size);
+        if (idx == 4)
+            n_deg_tree(size);
+        if (idx == 5) {
+            double cp = rnd.wnext(1.0, 2), fp = rnd.next(1.0 - cp);
+            chain_and_flower(size, cp, fp);
+        }
+        return *this;
+    }
+    /**
+     *  @brief  Generate a tree whose diameter is exactly `diameter`. A path
+     * of `diameter + 1` nodes is built first, and every other node hangs
+     * under a node that is far enough from both ends of it. Runs in
+     * \f$O(n)\f$.
+     *  @param  size The count of the nodes that will be generated.
+     *  @param  diameter The count of the edges on the longest path.
+     *  @return The graph itself.
+     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1, or
+     * no tree of that diameter exists.
+     */
+    inline _Self& diameter_tree(int size, int diameter) {
+        ensure(0 <= diameter && diameter < size);
+        ensure(diameter >= 2 || size == diameter + 1);
+        init(size);
+        auto slack = _scratch<int>(size + 1), pool = _scratch<int>();
+        for (int i = 1; i <= diameter + 1; i++) {
+            fa.at(i) = i - 1;
+            slack.at(i) = std::min(i - 1, diameter + 1 - i);
+            if (slack.at(i))
+                pool.push_back(i);
+        }
+        for (int i = diameter + 2; i <= size; i++) {
+            fa.at(i) = rnd.any(pool);
+            if ((slack.at(i) = slack.at(fa.at(i)) - 1))
+                pool.push_back(i);
+        }
+        return *this;
+    }
+    /**
+     *  @brief  Generate a random tree whose max degree is at most
+     * `max_degree`. Every node but \f$1\f$ has at most `max_degree` - 1
+     * children, and \f$1\f$, which has no father, up to `max_degree`, so
+     * \f$3\f$ gives a binary tree only when it is rooted at a leaf. Runs in
+     * \f$O(n)\f$.
+     *  @param  size The count of the nodes that will be generated.
+     *  @param  max_degree The sup of the degrees, counting the father.
+     *  @return The graph itself.
+     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
+     */
+    inline _Self& bounded_degree_tree(int size, int max_degree) {
+        ensure(max_degree >= 2 || (max_degree == 1 && size <= 2));
+        init(size);
+        auto deg = _scratch<int>(size + 1), pool = _scratch<int>(1);
+        pool[0] = 1;
+        for (int i = 2; i <= size; i++) {
+            int idx = rnd.next(int(pool.size()));
+            fa.at(i) = pool.at(idx);
+            if (++deg.at(fa.at(i)) == max_degree)
+                pool.at(idx) = pool.back(), pool.pop_back();
+            if ((deg.at(i) = 1) < max_degree)
+                pool.push_back(i);
+        }
+        return *this;
+    }
+    /**
+     *  @brief  Generate a caterpillar, that is a chain of `spine_length`
+     * nodes with all other nodes hanging on random nodes of the chain.
+     *  @param  size The count of the nodes that will be generated.
+     *  @param  spine_length The count of the nodes on the chain.
+     *  @return The graph itself.
+     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
+     */
+    inline _Self& caterpillar(int size, int spine_length) {
+        ensure(1 <= spine_length && spine_length <= size);
+        init(size);
+        for (int i = 2; i <= spine_length; i++)
+            fa.at(i) = i - 1;
+        for (int i = spine_length + 1; i <= size; i++)
+            fa.at(i) = rnd.next(1, spine_length);
+        return *this;
+    }
+    /**
+     *  @brief  Generate a broom, that is a chain of `handle_length` nodes with
+     * all other nodes hanging on the end of it. It is bad for the centroid
+     * and small-to-large heuristics.
+     *  @param  size The count of the nodes that will be generated.
+     *  @param  handle_length The count of the nodes on the chain.
+     *  @return The graph itself.
+     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
+     */
+    inline _Self& broom(int size, int handle_length) {
+        ensure(1 <= handle_length && handle_length <= size);
+        init(size);
+        for (int i = 2; i <= size; i++)
+            fa.at(i) = std::min(i - 1, handle_length);
+        return *this;
+    }
+    /**
+     *  @brief  The shape of a tree, see `info()`.
+     */
+    struct Info {
+        int diameter;    ///< The count of the edges on the longest path.
+        int max_degree;  ///< The max degree, counting the father.
+        int height;      ///< The count of the edges from the root to the
+                         ///< deepest node.
+    };
+    /**
+     *  @brief  Measure the generated tree in \f$O(n)\f$, to verify the
+     * generators above.
+     *  @return The diameter, max degree and height of the tree.
+     *  @throw  out_of_range if `fa` is not a tree with root \f$fa=0\f$.
+     */
+    inline Info info() {
+        auto head = _scratch<int>(n + 2), order = _scratch<int>(),
+             deg = _scratch<int>(n + 1);
+        int root = 0;
+        for (int i = 1; i <= n; i++)
+            fa.at(i) ? void(head.at(fa.at(i))++) : void(root = i);
+        for (int i = 1; i <= n; i++)
+            deg.at(i) = head.at(i) + (i != root);
+        for (int i = 1; i <= n + 1; i++)
+            head.at(i) += head.at(i - 1);
+        auto child = _scratch<int>(n);
+        for (int i = 1; i <= n; i++)
+            if (i != root)
+                child.at(--head.at(fa.at(i))) = i;
+        order.reserve(n), order.push_back(root);
+        for (int i = 0; i < int(order.size()); i++)
+            for (int j = head.at(order[i]); j < head.at(order[i] + 1); j++)
+                order.push_back(child[j]);
+        ensure(int(order.size()) == n);
+        Info res{0, *std::max_element(deg.begin(), deg.end()), 0};
+        auto depth = _scratch<int>(n + 1), down = _scratch<int>(n + 1);
+        for (int i = 1; i < n; i++)
+            depth.at(order[i]) = depth.at(fa.at(order[i])) + 1,
+            res.height = std::max(res.height, depth.at(order[i]));
+        for (int i = n - 1; i > 0; i--) {
+            int u = order[i], f = fa.at(u);
+            res.diameter = std::max(res.diameter, down.at(f) + down.at(u) + 1);
+            down.at(f) = std::max(down.at(f), down.at(u) + 1);
+        }
+        return res;
+    }
+    /**
+     *  @brief  Output the generated edges to stdout. NOTE that n will not be
+     * printed.
+     *  @param  weights the weights of the edges. Input weights[i] as the weight
+     * of the edge [fa[i], i].
+     *  @param  shuffled if I should print it in random order.
+     *  @return The graph itself.
+     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
+     */
+    inline _Self& print(int shuffled,
+                        const std::vector<int>& weights = std::vector<int>{}) {
+        CPGEN_PROFILE_SCOPE("Tree::print");
+        bool output_weight = true;
+        if (weights.size() == 0)
+            output_weight = false;
+        else if (int(weights.size()) != n + 1)
+            Quit("Invalid weights.size(): ", weights.size());
+        auto order = _scratch<int>(n + 1);
+        std::iota(order.begin(), order.end(), 0);
+        if (shuffled)
+            order = _rnd.shuffle(std::move(order), 2);
+        _out.write_edges(n - 1, output_weight, [&](size_t i) {
+            int u = order.at(i + 2);
+            return std::array<i64_ll, 3>{
+                u, fa.at(u), output_weight ? weights.at(u) : 0};
+        });
+        return *this;
+    }
+    /**
+     *  @brief  The same output as `print()`, formatted by `threads` threads
+     * (by default one per core), for trees of \f$10^7\f$ points and more.
+     *  @return The tree itself.
+     */
+    inline _Self& print_parallel(int shuffled,
+                                 const std::vector<int>& weights = {},
+                                 int threads = 0) {
+        CPGEN_PROFILE_SCOPE("Tree::print_parallel");
+        bool output_weight = !weights.empty();
+        if (output_weight && int(weights.size()) != n + 1)
+            Quit("Invalid weights.size(): ", weights.size());
+        auto order = _scratch<int>(n + 1);
+        std::iota(order.begin(), order.end(), 0);
+        if (shuffled)
+            order = _rnd.shuffle(std::move(order), 2);
+        const int* u = order.data() + 2;
+        _out.write_edges_parallel(
+            n - 1, output_weight,
+            [&](size_t i) {
+                return std::array<i64_ll, 3>{
+                    u[i], fa[u[i]], output_weight ? weights[u[i]] : 0};
+            },
+            threads);
+        return *this;
+    }
+    /**
+     *  @brief  Output the generated `fa` array to stdout. NOTE that n will not
+     * be printed.
+     *  @param sep The seperator.
+     *  @param end the end char.
+     *  @param  shuffled if I should print it in random order.
+     *  @return The graph itself.
+     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
+     */
+    inline _Self& print_fa(char sep = ' ', char end = '\n') {
+        _out.write_seq(fa.begin() + 2, fa.end(), sep, end);
+        return *this;
+    }
+    /**
+     *  @brief  Get the leave nodes of the current tree.
+     *  @return The leaves.
+     *  @throw  It throws what `std::vector<int>` throws.
+     */
+    inline std::vector<int> get_leaves() {
+        auto is_leave = _scratch<char>(n + 1);
+        for (int i = 1; i <= n; i++)
+            is_leave.at(fa.at(i)) = 1;
+        leaves.clear();
+        for (int i = 1; i <= n; i++)
+            if (!is_leave.at(i))
+                leaves.push_back(i);
+        return leaves;
+    }
+    /**
+     *  @brief  Hash the shape of the tree in \f$O(n)\f$, like the AHU
+     * encoding: every point hashes the multiset of the hashes of its
+     * children, by a sum of mixed values instead of sorting. The unrooted
+     * shape is rooted at the center, and with two centers the hashes of the
+     * two halves are combined.
+     *  @param  rooted if the root (the point whose `fa` is \f$0\f$) is
+     * fixed.
+     *  @return The hash. Isomorphic trees always get the same hash, and
+     * other trees collide with a negligible probability.
+     *  @throw  out_of_range if `fa` is not a tree.
+     */
+    inline unsigned long long canonical_hash(bool rooted = false) {
+        auto head = _scratch<int>(n + 2), adj = _scratch<int>(2 * n);
+        int root = 0;
+        for (int i = 1; i <= n; i++)
+            if (fa.at(i))
+                head[i]++, head.at(fa[i])++;
+            else
+                root = i;
+        ensure(root);
+        for (int i = 1; i <= n + 1; i++)
+            head[i] += head[i - 1];
+        for (int i = 1; i <= n; i++)
+            if (fa[i])
+                adj[--head[i]] = fa[i], adj[--head[fa[i]]] = i;
+        auto order = _scratch<int>(), par = _scratch<int>(n + 1);
+        order.reserve(n);
+        if (rooted) {
+            order.push_back(root);
+        } else {
+            // Peel the leaves layer by layer, the last 1 or 2 are centers.
+            auto deg = _scratch<int>(n + 1);
+            for (int i = 1; i <= n; i++)
+                if ((deg[i] = head[i + 1] - head[i]) <= 1)
+                    order.push_back(i);
+            size_t done = 0;
+            for (int rest = n; rest > 2;) {
+                size_t end = order.size();
+                for (rest -= end - done; done < end; done++)
+                    for (int j = head[order[done]]; j < head[order[done] + 1];
+                         j++)
+                        if (--deg[adj[j]] == 1)
+                            order.push_back(adj[j]);
+            }
+            order.erase(order.begin(), order.begin() + done);
+        }
+        int roots = order.size();
+        ensure(roots == 1 || roots == 2);
+        if (roots == 2)
+            par[order[0]] = order[1], par[order[1]] = order[0];
+        for (size_t i = 0; i < order.size(); i++)
+            for (int j = head[order[i]]; j < head[order[i] + 1]; j++)
+                if (adj[j] != par[order[i]])
+                    par[adj[j]] = order[i], order.push_back(adj[j]);
+        ensure(int(order.size()) == n);
+        auto sum = _scratch<unsigned long long>(n + 1);
+        for (int i = n - 1; i >= roots; i--)
+            sum[par[order[i]]] +=
+                _mix64(_mix64(sum[order[i]] + 1) ^ 0x5bd1e995);
+        if (roots == 1)
+            return _mix64(sum[order[0]] + 1);
+        return _mix64(_mix64(_mix64(sum[order[0]] + 1) ^ 0x5bd1e995) +
+                      _mix64(_mix64(sum[order[1]] + 1) ^ 0x5bd1e995) + 2);
+    }
+};
+
+/**
+ *  @brief  Remembers the shapes of the generated trees, so that no two
+ * trees of a test pack are isomorphic, by `Tree::canonical_hash()`. It never
+ * compares two trees, so \f$T\f$ trees cost \f$O(\sum n)\f$:
+ * ```
+ * TreeRegistry seen;
+ * pack.split(2000, 300).run(tree, [&](Tree& t, int n) {
+ *     seen.unique(t, [&](Tree& t) { t.random_shaped_tree(n); });
+ *     _out.println(n), t.print(1);
+ * });
+ * ```
+ * A hash collision can only reject a new tree, never accept a duplicate.
+ */
+class TreeRegistry {
+   public:
+    bool rooted = false;  ///< If the trees are compared as rooted trees.
+    TreeRegistry(bool rooted_trees = false) : rooted(rooted_trees) {}
+    /**
+     *  @brief  Register the shape of `tr`.
+     *  @return If the shape is new.
+     */
+    inline bool insert(Tree& tr) {
+        return _seen.insert(tr.canonical_hash(rooted)).second;
+    }
+    /**
+     *  @brief  If the shape of `tr` is registered.
+     */
+    inline bool contains(Tree& tr) {
+        return _seen.count(tr.canonical_hash(rooted));
+    }
+    /**
+     *  @brief  Call `gen(tr)` until `tr` gets a new shape, and register it.
+     *  @param  tr the tree to be generated.
+     *  @param  gen any callable that generates `tr`.
+     *  @param  max_tries the sup of the calls.
+     *  @return The tree.
+     *  @throw  Throws GenException when no new shape is generated after
+     * `max_tries` calls, e.g. all the shapes of that size are used.
+     */
+    template <typename _Func>
+    inline Tree& unique(Tree& tr, _Func gen, int max_tries = 1000) {
+        for (int i = 0; i < max_tries; i++) {
+            gen(tr);
+            if (insert(tr))
+                return tr;
+            CPGEN_PROFILE_COUNT(rejects, 1);
+        }
+        throw GenException(
+            format("No new tree of size %d after %d tries.", tr.n, max_tries));
+    }
+    /**
+     *  @brief  The count of the registered shapes.
+     */
+    inline size_t size() const { return _seen.size(); }
+    inline void clear() { _seen.clear(); }
+
+   private:
+    std::unordered_set<unsigned long long> _seen;
+};
+
+/**
+ *  @brief  Class that enumerates all the \f$n^{n-2}\f$ labelled trees of
+ * size \f$n\f$, in the order of their Prüfer sequences. `next()` steps the
+ * sequence like an odometer and decodes it into `tree` in \f$O(n)\f$ (the
+ * decoding is not incremental, so a step is not \f$O(1)\f$ amortized, but
+ * printing the tree costs \f$O(n)\f$ anyway). The labels \f$1\f$ and
+ * \f$n\f$ of the decoded tree are swapped, so it is rooted at \f$1\f$ as
+ * `print()` expects:
+ * ```
+ * LabelledTrees all;
+ * all.init(6);
+ * do
+ *     all.tree.print(0);
+ * while (all.next());
+ * ```
+ */
+class LabelledTrees {
+   public:
+    using _Self = LabelledTrees;
+    Tree tree;  ///< The current tree.
+    /**
+     *  @brief  Start from the first tree of size `size`, the star of \f$1\f$.
+     *  @param  size the size of the trees.
+     *  @return The enumerator itself.
+     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
+     */
+    inline _Self& init(int size) {
+        tree.init(size);
+        _code.assign(size + 1, 1), _deg.assign(size + 1, 0);
+        if (size >= 2)
+            _code[size - 1] = size, _deg[1] = size - 2;
+        _decode();
+        return *this;
+    }
+    /**
+     *  @brief  Step to the next tree.
+     *  @return If there is a next tree. Otherwise `tree` is back to the
+     * first one.
+     */
+    inline bool next() {
+        int n = tree.n, i = n - 2;
+        for (; i >= 1 && _code[i] == n; i--)
+            _deg[n]--, _code[i] = 1, _deg[1]++;
+        if (i >= 1)
+            _deg[_code[i]]--, _deg[++_code[i]]++;
+        _decode();
+        return i >= 1;
+    }
+
+   private:
+    std::vector<int> _code;  ///< The Prüfer sequence, and `_code[n-1] = n`.
+    std::vector<int> _deg;   ///< `_deg[i]` is the count of \f$i\f$ in it.
+    std::vector<int> _left;  ///< Reused by `_decode()`.
+    /**
+     *  @brief  Decode `_code` into `tree` in linear time.
+     */
+    inline void _decode() {
+        int n = tree.n;
+        std::vector<int>& fa = tree.fa;
+        _left = _deg, fa[n] = 0;
+        for (int i = 1, j = 1; i < n; ++i, ++j) {
+            while (_left[j])
+                ++j;
+            fa[j] = _code[i];
+            while (i < n && !--_left[_code[i]] && _code[i] < j)
+                fa[_code[i]] = _code[i + 1], ++i;
+        }
+        // The decoded tree is rooted at n, swap the labels of 1 and n.
+        for (int i = 1; i <= n; i++)
+            if (fa[i] == 1 || fa[i] == n)
+                fa[i] = 1 + n - fa[i];
+        std::swap(fa[1], fa[n]);
+    }
+};
+
+/**
+ *  @brief  Class that enumerates all the unlabelled rooted trees of size
+ * \f$n\f$, each exactly once, by the successor of Beyer and Hedetniemi on
+ * their canonical level sequences. `next()` takes \f$O(1)\f$ amortized time,
+ * and only rewrites the fathers that change. The points are numbered in
+ * preorder, so `fa[i] < i` and the root is \f$1\f$:
+ * ```
+ * RootedTrees all;
+ * all.init(10);  // 719 trees
+ * do
+ *     all.tree.print(0);
+ * while (all.next());
+ * ```
+ */
+class RootedTrees {
+   public:
+    using _Self = RootedTrees;
+    Tree tree;  ///< The current tree.
+    /**
+     *  @brief  Start from the first tree of size `size`, the chain.
+     *  @param  size the size of the trees.
+     *  @return The enumerator itself.
+     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
+     */
+    inline _Self& init(int size) {
+        tree.init(size), _level.resize(size + 1);
+        for (int i = 1; i <= size; i++)
+            _level[i] = i, tree.fa[i] = i - 1;
+        return *this;
+    }
+    /**
+     *  @brief  Step to the next tree, the last one is the star.
+     *  @return If there is a next tree. Otherwise `tree` is unchanged.
+     */
+    inline bool next() {
+        int n = tree.n, p = n, q;
+        while (p > 1 && _level[p] == 2)
+            p--;
+        if (p <= 1)
+            return false;
+        for (q = p - 1; _level[q] != _level[p] - 1;)
+            q--;
+        // Repeat the subtree of q before p, from p to the end.
+        std::vector<int>& fa = tree.fa;
+        for (int i = p, d = p - q; i <= n; i++) {
+            _level[i] = _level[i - d];
+            fa[i] = fa[i - d] >= q ? fa[i - d] + d : fa[i - d];
+        }
+        return true;
+    }
+
+   private:
+    std::vector<int> _level;  ///< The depth of each point, from \f$1\f$.
+};
+
+/**
+ *  @brief  The access policy that checks every index, for debugging.
+ */
+struct CheckedAccess {
+    static constexpr bool checked = true;
+};
+/**
+ *  @brief  The access policy that trusts every index, so that the loops of
+ * the generators are as tight as a raw array.
+ */
+struct UncheckedAccess {
+    static constexpr bool checked = false;
+};
+/**
+ *  @brief  Checked in debug builds, and unchecked when `NDEBUG` is defined.
+ */
+#ifdef NDEBUG
+using DefaultAccess = UncheckedAccess;
+#else
+using DefaultAccess = CheckedAccess;
+#endif
+
+/**
+ *  @brief  The indexing policy that `a[1]` is the first element, as
+ * everywhere else in CPgen.
+ */
+struct OneBased {
+    static constexpr int base = 1;
+};
+/**
+ *  @brief  The indexing policy that `a[0]` is the first element.
+ */
+struct ZeroBased {
+    static constexpr int base = 0;
+};
+
+/**
+ *  @brief  The type that a sum of `_Tp` is accumulated in: `i64_ll` for
+ * integers up to 32 bits, `i128_ll` for 64-bit integers, and at least
+ * `double` for floating-point values.
+ */
+template <typename _Tp, typename = void>
+struct Accumulator {
+    using type = _Tp;
+};
+template <typename _Tp>
+struct Accumulator<_Tp, std::enable_if_t<std::is_integral<_Tp>::value>> {
+    using type = std::conditional_t<(sizeof(_Tp) < 8), i64_ll, i128_ll>;
+};
+template <typename _Tp>
+struct Accumulator<_Tp,
+                   std::enable_if_t<std::is_floating_point<_Tp>::value>> {
+    using type = std::conditional_t<(sizeof(_Tp) < sizeof(double)), double,
+                                    _Tp>;
+};
+
+/**
+ *  @brief  The narrowest signed type that holds \f$[L, R]\f$, starting from
+ * `short`, since the `char` types are printed as characters.
+ */
+template <i64_ll L, i64_ll R>
+using _narrowest_t = std::conditional_t<
+    (L >= SHRT_MIN && R <= SHRT_MAX),
+    short,
+    std::conditional_t<(L >= INT_MIN && R <= INT_MAX), int, i64_ll>>;
+
+/**
+ *  @brief  Class that used to generate an array.
+ *  @param  _Tp the type of the elements.
+ *  @param  _Access `CheckedAccess` or `UncheckedAccess`.
+ *  @param  _Index `OneBased` or `ZeroBased`, which only changes
+ * `operator[]` and `begin()`: the elements are always stored in
+ * `array[1..n]`.
+ */
+template <typename _Tp,
+          typename _Access = DefaultAccess,
+          typename _Index = OneBased>
+class Array {
+   public:
+    using _Sequence = std::vector<_Tp>;
+    using _Self = Array<_Tp, _Access, _Index>;
+    using _Sum = typename Accumulator<_Tp>::type;
+    int n = 0;        ///< size of the array that generated.
+    _Sequence array;  ///< The container of the elements.
+    /**
+     *  @brief  return the reference of the size-th element in this array.
+     *  @param  idx the index of the element you requested.
+     *  @return The reference of the element.
+     *  @throw  out_of_range if idx is an invalid index and the access is
+     * checked.
+     */
+    inline _Tp& operator[](int idx) {
+        if constexpr (_Access::checked)
+            ensure(_Index::base <= idx && idx < _Index::base + n);
+        return _at(idx + 1 - _Index::base);
+    }
+    /**
+     *  @brief  return the reference of the first element in this array.
+     * With `OneBased`, it is the ignored place before the first element.
+     *  @return The reference of the element.
+     *  @throw  It throws what the _Sequence throws.
+     */
+    inline auto begin() { return array.begin() + (1 - _Index::base); }
+    /**
+     *  @brief  return the reference of the last element in this array.
+     *  @return The reference of the element.
+     *  @throw  It throws what the _Sequence throws.
+     */
+    inline auto end() { return array.end(); }
+    /**
+     *  @brief  init the whole array with the size of `size`.
+     *  @param  size how large this array should be.
+     *  @return no return.
+     *  @throw  It throws what the _Sequence throws.
+     */
+    inline void init(int size) {
+        if (size < 1)
+            throw GenException(
+                format("Invalid 'n' has been passed in `init`: %d", size));
+        array.clear();
+        if (array.capacity() < size_t(size) + 1)
+            CPGEN_PROFILE_COUNT(allocs, 1),
+                CPGEN_PROFILE_COUNT(alloc_bytes, (size + 1) * sizeof(_Tp));
+        n = size, array.resize(n + 1);
+    }
+    /**
+     *  @brief  Output the current array.
+     *  @return The array itself.
+     *  @throw  It throws what the _Sequence throws.
+     */
+    inline void print(char sep = ' ', char end = '\n') {
+        CPGEN_PROFILE_SCOPE("Array::print");
+        _out.write_seq(array.begin() + 1, array.begin() + n + 1, sep, end);
+    }
+    /**
+     *  @brief  The same output as `print()`, formatted by `threads` threads
+     * (by default one per core), for arrays of \f$10^7\f$ elements and
+     * more.
+     */
+    inline void print_parallel(int threads = 0,
+                               char sep = ' ',
+                               char end = '\n') {
+        CPGEN_PROFILE_SCOPE("Array::print_parallel");
+        const _Tp* p = array.data() + 1;
+        _out.write_seq_parallel(
+            n, [p](size_t i) { return p[i]; }, sep, end, threads);
+    }
+    /**
+     *  @brief  Get the sum of the elements.
+     *  @return The sum of the elements, in `Accumulator<_Tp>::type`.
+     *  @throw  It throws what the _Sequence throws.
+     */
+    inline _Sum sum() {
+        _Sum current_sum = 0;
+        for (int i = 1; i <= n; i++)
+            current_sum += _at(i);
+        return current_sum;
+    }
+    /**
+     *  @brief  Generate an array with size `size`, while its elements are
+     * values in [wl, wr].
+     *  @param  size how large this array should be.
+     *  @param  wl the sub of the elements.
+     *  @param  wr the sup of the elements.
+     *  @return The array itself.
+     *  @throw  It throws what the _Sequence throws.
+     */
+    inline _Self& basic_gen(int size, _Tp wl, _Tp wr) {
+        init(size);
+        for (int i = 1; i <= size; i++)
+            _at(i) = rnd.next(wl, wr);
+        return *this;
+    }
+    /**
+     *  @brief  Generate an array with size `size`, while its elements are
+     * values in \f$[L, R]\f$ known at compile time, so the narrowest draw
+     * of rnd is chosen, e.g. `basic_gen<1, 100>(n)`.
+     *  @param  size how large this array should be.
+     *  @return The array itself.
+     *  @throw  It throws what the _Sequence throws.
+     */
+    template <i64_ll L, i64_ll R>
+    inline _Self& basic_gen(int size) {
+        static_assert(L <= R, "Empty range.");
+        static_assert(!std::is_integral<_Tp>::value ||
+                          (L >= i64_ll(std::numeric_limits<_Tp>::min()) &&
+                           (R <= 0 || (unsigned long long)R <=
+                                          (unsigned long long)
+                                              std::numeric_limits<_Tp>::max())),
+                      "The range does not fit in _Tp.");
+        constexpr unsigned long long span =
+            (unsigned long long)R - (unsigned long long)L;
+        init(size);
+        _Tp* p = array.data();
+        for (int i = 1; i <= size; i++)
+            if constexpr (span < INT_MAX)
+                p[i] = _Tp(L + rnd.next(int(span + 1)));
+            else if constexpr (span < LLONG_MAX)
+                p[i] = _Tp(L + rnd.next((long long)(span + 1)));
+            else
+                p[i] = _Tp(rnd.next(L, R));
+        return *this;
+    }
+    /**
+     *  @brief  Sort the current array.
+     *  @throw  It throws what the _Sequence throws.
+     */
+    inline void sort() {
+        std::sort(array.begin() + 1, array.begin() + n + 1);
+    }
+    /**
+     *  @brief  Shuffle the current array.
+     *  @throw  It throws what the _Sequence throws.
+     */
+    inline void shuffle() { array = _rnd.shuffle(std::move(array), 1, n); }
+    /**
+     *  @brief  Reverse the current array.
+     *  @throw  It throws what the _Sequence throws.
+     */
+    inline void reverse() {
+        std::reverse(array.begin() + 1, array.begin() + n + 1);
+    }
+    /**
+     *  @brief  Turn this array into the Diffrence array of it.
+     *  @return The array itself.
+     *  @throw  It throws what the _Sequence throws.
+     */
+    inline _Self& to_diffrence() {
+        for (int i = n; i >= 1; i--)
+            _at(i) -= _at(i - 1);
+        return *this;
+    }
+    /**
+     *  @brief  Generate an array with size `size`, while its elements are 0
+     * or 1.
+     *  @param  size how large this array should be.
+     *  @return The array itself.
+     *  @throw  It throws what the _Sequence throws.
+     */
+    inline _Self& binary_gen(int size) { return basic_gen(size, 0, 1); }
+    /**
+     *  @brief  Generate an array with size `size`, while its elements are not
+     * decreasing.
+     *  @param  size how large this array should be.
+     *  @param  wl the sub of the elements.
+     *  @param  wr the sup of the elements.
+     *  @return The array itself.
+     *  @throw  It throws what the _Sequence throws.
+     */
+    inline _Self& ascending_array(int size, _Tp wl, _Tp wr) {
+        basic_gen(size, wl, wr);
+        sort();
+        return *this;
+    }
+    /**
+     *  @brief  Generate an array with size `size`, while its elements are not
+     * increasing.
+     *  @param  size how large this array should be.
+     *  @param  wl the sub of the elements.
+     *  @param  wr the sup of the elements.
+     *  @return The array itself.
+     *  @throw  It throws what the _Sequence throws.
+     */
+    inline _Self& decending_array(int size, _Tp wl, _Tp wr) {
+        ascending_array(size, wl, wr);
+        reverse();
+        return *this;
+    }
+    /**
+     *  @brief  Generate an array with size `size`, while the sum of its
+     * elements are a constant.
+     *  @param  size how large this array should be.
+     *  @param  sum the sum of the elements.
+     *  @param  AcceptZero if the array can contain zero or not.
+     *  @param  AcceptNegative if the array can contain negative values or not.
+     *  @return The array itself.
+     *  @throw  It throws what the _Sequence throws.
+     */
+    inline _Self& constant_sum(int size,
+                               _Tp sum,
+                               bool AcceptZero = true,
+                               bool AcceptNegative = true) {
+        init(size);
+        _Tp total = AcceptZero ? sum : sum - size;
+        for (int i = 1; i < size; i++)
+            _at(i) =
+                rnd.next(std::min(_Tp(0), total), std::max(_Tp(0), total));
+        _at(size) = total;
+        (AcceptNegative ? void(nullptr) : sort()), to_diffrence();
+        if (!AcceptZero) {
+            for (int i = 1; i <= size; i++)
+                _at(i)++;
+        }
+        return *this;
+    }
+    /**
+     *  @brief  Perturbe the current array, keeping the sum of the elements
+     * still.
+     *  @return The array itself.
+     *  @throw  It throws what the _Sequence throws.
+     */
+    inline _Self& perturbe(_Tp range = 1) {
+        // a[i] += x[i] - x[i - 1], where x[0] = x[n] = 0.
+        auto x = _scratch<_Tp>(n + 1);
+        for (int i = 1; i < n; i++)
+            x[i] = rnd.next(-range, range);
+        for (int i = n; i >= 1; i--)
+            _at(i) += x[i] - x[i - 1];
+        return *this;
+    }
+    /**
+     *  @brief  Generate a permutation of 1 to size.
+     *  @param  size the size of the array.
+     *  @return The array itself.
+     *  @throw  It throws what the _Sequence throws.
+     */
+    inline _Self& permutation(int size) {
+        init(size);
+        std::iota(array.begin(), array.end(), 0);
+        array = _rnd.shuffle(std::move(array));
+        return *this;
+    }
+    /**
+     *  @brief  Generate distinct keys that collide in `std::unordered_map` /
+     * `std::unordered_set` of libstdc++, whose hash of an integer is itself
+     * and whose bucket counts are primes. While the table has \f$p\f$
+     * buckets, the multiples of \f$p\f$ fall into one bucket. Let
+     * \f$p_{k-2} < p_{k-1} < n \le p_k\f$ be the bucket counts it goes
+     * through. The keys are multiples of \f$p_{k-1} p_k\f$ if they fit in
+     * `wr`, so all the inserts after the \f$p_{k-2}\f$-th collide. Else
+     * they are multiples of \f$p_k\f$ or \f$p_{k-1}\f$, whichever keeps
+     * more inserts colliding (at least about \f$n/4\f$). Either way,
+     * inserting them takes \f$\Theta(n^2)\f$ time.
+     *  @param  size how large this array should be.
+     *  @param  wr the sup of the keys.
+     *  @param  prime the modulus of the keys, by default chosen as above.
+     * After a `reserve()`, pass the bucket count it gives.
+     *  @return The array itself.
+     *  @throw  Throws GenException if `size` multiples of the prime do not
+     * fit in \f$[1, wr]\f$.
+     */
+    inline _Self& hash_killer(int size, _Tp wr, i64_ll prime = 0) {
+        static_assert(std::is_integral<_Tp>::value, "The keys are integers.");
+        // The bucket counts of libstdc++ as a table grows, up to the first
+        // one above INT_MAX, so every `size` has one.
+        static const i64_ll primes[] = {
+            13,        29,        59,         127,        257,
+            541,       1109,      2357,       5087,       10273,
+            20753,     42043,     85229,      172933,     351061,
+            712697,    1447153,   2938679,    5967347,    12117689,
+            24607243,  49969847,  101473717,  206062531,  418451333,
+            849749479, 1725587117, 3504151727};
+        if (!prime) {
+            int k = 0;
+            while (primes[k] < size)
+                k++;
+            // The table has `hi` buckets for the inserts in (lo, size], and
+            // `lo` buckets for the ones in (lower, lo].
+            i64_ll hi = primes[k], lo = k ? primes[k - 1] : 0,
+                   lower = k > 1 ? primes[k - 2] : 0;
+            if (lo && i64_ll(wr) / lo / hi >= size)
+                prime = lo * hi;
+            else
+                prime = lo - lower > size - lo ? lo : hi;
+        }
+        i64_ll slots = i64_ll(wr) / prime;
+        if (slots < size)
+            throw GenException(format(
+                "Only %lld multiples of %lld are in [1, %lld], %d wanted.",
+                slots, prime, i64_ll(wr), size));
+        init(size);
+        // Distinct multipliers: one in each of `size` equal ranges.
+        i64_ll step = slots / size;
+        for (int i = 1; i <= size; i++)
+            _at(i) = _Tp(prime * ((i - 1) * step + rnd.next(1ll, step)));
+        array = _rnd.shuffle(std::move(array));
+        return *this;
+    }
+    /**
+     *  @brief  Generate a permutation of \f$[1, n]\f$ that makes `std::sort`
+     * as slow as it can, by the adversary of McIlroy ("A Killer Adversary
+     * for Quicksort"): `std::sort` runs once on the indexes with a
+     * comparator that fixes the values only when it has to, always in the
+     * way that makes the pivot bad. Sorting the result repeats the same
+     * comparisons, which drives introsort to its heapsort fallback, and a
+     * quicksort with the same pivot choice to \f$\Theta(n^2)\f$. It takes
+     * \f$O(n \log n)\f$ time.
+     *  @param  size how large this array should be.
+     *  @return The array itself.
+     */
+    inline _Self& antiqsort(int size) {
+        init(size);
+        auto val = _scratch<int>(size), idx = _scratch<int>(size);
+        const int gas = size;
+        int solid = 0, candidate = -1;
+        std::fill(val.begin(), val.end(), gas);
+        std::iota(idx.begin(), idx.end(), 0);
+        std::sort(idx.begin(), idx.end(), [&](int x, int y) {
+            if (val[x] == gas && val[y] == gas)
+                val[x == candidate ? x : y] = solid++;
+            if (val[x] == gas)
+                candidate = x;
+            else if (val[y] == gas)
+                candidate = y;
+            return val[x] < val[y];
+        });
+        for (int i = 0; i < size; i++)
+            _at(i + 1) = _Tp((val[i] == gas ? solid++ : val[i]) + 1);
+        return *this;
+    }
+    /**
+     *  @brief  Generate the median-of-3 killer of Musser, a permutation of
+     * \f$[1, n]\f$ on which the quicksort that takes the median of the
+     * first, middle and last elements as the pivot (the one of the SGI STL,
+     * copied by many hand-written sorts) removes only 2 elements per
+     * partition, so it takes \f$\Theta(n^2)\f$ time. The construction needs
+     * \f$n/2\f$ to be even, so it is built on the first \f$n - n \bmod 4\f$
+     * elements and the at most 3 largest values follow in order. It takes
+     * \f$O(n)\f$ time.
+     *  @param  size how large this array should be.
+     *  @return The array itself.
+     */
+    inline _Self& median_of_three_killer(int size) {
+        init(size);
+        int k = size / 4 * 2;
+        for (int i = 1; i <= k; i++)
+            _at(i) = _Tp(i % 2 ? i : k + i - 1), _at(k + i) = _Tp(2 * i);
+        for (int i = 2 * k + 1; i <= size; i++)
+            _at(i) = _Tp(i);
+        return *this;
+    }
+    /**
+     *  @brief  Generate an array with the i-th element is f(i + begin).
+     *  @param  size the size of the array.
+     *  @param  GenerateFunction the GenerateFunction of the array.
+     *  @param  begin the begin point of the array.
+     *  @return The array itself.
+     *  @throw  It throws what the _Sequence throws.
+     */
+    inline _Self& generate_function(int size,
+                                    int (*GenerateFunction)(int),
+                                    int begin = 1) {
+        init(size);
+        for (int i = 0; i < size; i++)
+            _at(i + 1) = GenerateFunction(i + begin);
+        return *this;
+    }
+    /**
+     *  @brief  Generate an array with the i-th element is f(a_{i-1}).
+     *  @param  size the size of the array.
+     *  @param  GenerateFunction the GenerateFunction of the array.
+     *  @param  begin the begin value of the array.
+     *  @return The array itself.
+     *  @throw  It throws what the _Sequence throws.
+     */
+    inline _Self& generate_iterate_function(int size,
+                                            int (*IterateFunction)(int),
+                                            int begin = 1) {
+        init(size);
+        _at(1) = begin;
+        for (int i = 2; i <= size; i++)
+            _at(i) = IterateFunction(_at(i - 1));
+        return *this;
+    }
+    inline _Self& randomly_insert(int size, int num) {
+        while (size-- > 0)
+            _at(rnd.next(1, n)) = num;
+        return *this;
+    }
+
+   private:
+    /**
+     *  @brief  The element at `array[idx]`, checked by `_Access`.
+     */
+    inline _Tp& _at(size_t idx) {
+        if constexpr (_Access::checked)
+            return array.at(idx);
+        else
+            return array[idx];
+    }
+};
+
+/**
+ *  @brief  An array whose elements are in \f$[L, R]\f$ known at compile
+ * time, stored in the narrowest type, e.g. `RangedArray<0, 1000>` stores
+ * `short`s.
+ */
+template <i64_ll L,
+          i64_ll R,
+          typename _Access = DefaultAccess,
+          typename _Index = OneBased>
+class RangedArray : public Array<_narrowest_t<L, R>, _Access, _Index> {
+   public:
+    using _Base = Array<_narrowest_t<L, R>, _Access, _Index>;
+    /**
+     *  @brief  Generate an array with size `size`, while its elements are
+     * values in \f$[L, R]\f$.
+     *  @param  size how large this array should be.
+     *  @return The array itself.
+     */
+    inline RangedArray& gen(int size) {
+        _Base::template basic_gen<L, R>(size);
+        return *this;
+    }
+};
+
+/**
+ *  @brief  Class that enumerates all the arrays of size \f$n\f$ whose
+ * elements are in \f$[lo, hi]\f$, in lexicographical order. `next()` steps
+ * `array` like an odometer, in \f$O(1)\f$ amortized time:
+ * ```
+ * ArrayBox<int> all;
+ * all.init(5, 1, 3);  // 243 arrays
+ * do
+ *     all.array.print();
+ * while (all.next());
+ * ```
+ */
+template <typename _Tp>
+class ArrayBox {
+   public:
+    using _Self = ArrayBox<_Tp>;
+    Array<_Tp> array;  ///< The current array.
+    _Tp lo{}, hi{};    ///< The range of the elements.
+    /**
+     *  @brief  Start from the first array, all of whose elements are `low`.
+     *  @param  size the size of the arrays.
+     *  @param  low, high the range of the elements.
+     *  @return The enumerator itself.
+     *  @throw  out_of_range if @a size is invalid or `low > high`.
+     */
+    inline _Self& init(int size, _Tp low, _Tp high) {
+        ensure(low <= high);
+        array.init(size), lo = low, hi = high;
+        std::fill(array.array.begin() + 1, array.array.end(), lo);
+        return *this;
+    }
+    /**
+     *  @brief  Step to the next array.
+     *  @return If there is a next array. Otherwise `array` is back to the
+     * first one.
+     */
+    inline bool next() {
+        for (int i = array.n; i >= 1; i--) {
+            if (array.array[i] < hi)
+                return ++array.array[i], true;
+            array.array[i] = lo;
+        }
+        return false;
+    }
+};
+
+
+/**
+ *  @brief  An array that is never stored: the i-th element is computed from
+ * a counter-based RNG (the i-th output of splitmix64 seeded with `seed`)
+ * whenever it is read, in \f$O(1)\f$. So any slice of a huge array can be
+ * checked, summed or printed alone, by any thread, and always agrees with
+ * the others. `seed` is drawn from rnd, so it follows argv as usual:
+ * ```
+ * LazyArray<int> arr;
+ * arr.basic_gen(100000000, 1, 1000000000);
+ * _out.println(arr.n), arr.print();
+ * long long head = 0;
+ * for (int i = 1; i <= 10; i++)
+ *     head += arr[i];
+ * ensure(arr.sum(1, 10) == head);  // without generating the others
+ * ```
+ * Only the generators whose elements are independent are lazy.
+ */
+template <typename _Tp>
+class LazyArray {
+   public:
+    using _Self = LazyArray<_Tp>;
+    using _Sum = typename Accumulator<_Tp>::type;
+    int n = 0;                    ///< The size of the array.
+    unsigned long long seed = 0;  ///< The seed of the counter-based RNG.
+    /**
+     *  @brief  Read the elements in \f$[first, last)\f$, for
+     * `Output::write_seq` and <algorithm>.
+     */
+    struct iterator {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = _Tp;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = _Tp;
+        const LazyArray* array;
+        int idx;
+        inline _Tp operator*() const { return array->_get(idx); }
+        inline iterator& operator++() { return ++idx, *this; }
+        inline iterator operator++(int) { return {array, idx++}; }
+        inline bool operator==(const iterator& rhs) const {
+            return idx == rhs.idx;
+        }
+        inline bool operator!=(const iterator& rhs) const {
+            return idx != rhs.idx;
+        }
+    };
+    /**
+     *  @brief  The i-th element, 1-indexed.
+     *  @throw  out_of_range if idx is an invalid index and the access is
+     * checked.
+     */
+    inline _Tp operator[](int idx) const {
+        if constexpr (DefaultAccess::checked)
+            ensure(1 <= idx && idx <= n);
+        return _get(idx);
+    }
+    inline iterator begin() const { return {this, 1}; }
+    inline iterator end() const { return {this, n + 1}; }
+    /**
+     *  @brief  The random 64-bit word behind the i-th element.
+     */
+    inline unsigned long long bits(int idx) const {
+        return _mix64(seed + (unsigned long long)idx * 0x9e3779b97f4a7c15ull);
+    }
+    /**
+     *  @brief  The array of size `size`, while its elements are values in
+     * [wl, wr].
+     *  @return The array itself.
+     *  @throw  out_of_range if the range is empty.
+     */
+    inline _Self& basic_gen(int size, _Tp wl, _Tp wr) {
+        ensure(wl <= wr);
+        _init(size), _lo = wl, _hi = wr;
+        return *this;
+    }
+    inline _Self& binary_gen(int size) { return basic_gen(size, 0, 1); }
+    /**
+     *  @brief  The array whose i-th element is f(i + begin - 1), like
+     * `Array::generate_function`.
+     *  @return The array itself.
+     */
+    inline _Self& generate_function(int size,
+                                    _Tp (*GenerateFunction)(int),
+                                    int begin = 1) {
+        _init(size), _func = GenerateFunction, _begin = begin;
+        return *this;
+    }
+    /**
+     *  @brief  The sum of the elements in \f$[l, r]\f$, without storing
+     * them.
+     */
+    inline _Sum sum(int l, int r) const {
+        ensure(1 <= l && r <= n);
+        _Sum current_sum = 0;
+        for (int i = l; i <= r; i++)
+            current_sum += _get(i);
+        return current_sum;
+    }
+    inline _Sum sum() const { return sum(1, n); }
+    /**
+     *  @brief  Store the elements into an `Array`.
+     */
+    inline Array<_Tp> materialize() const {
+        Array<_Tp> res;
+        res.init(n);
+        for (int i = 1; i <= n; i++)
+            res.array[i] = _get(i);
+        return res;
+    }
+    /**
+     *  @brief  Output the elements in \f$[l, r]\f$, by default all of them.
+     *  @return The array itself.
+     */
+    inline _Self& print(int l = 1,
+                        int r = -1,
+                        char sep = ' ',
+                        char end = '\n') {
+        CPGEN_PROFILE_SCOPE("LazyArray::print");
+        if (r == -1)
+            r = n;
+        ensure(1 <= l && l <= r + 1 && r <= n);
+        _out.write_seq(iterator{this, l}, iterator{this, r + 1}, sep, end);
+        return *this;
+    }
+    /**
+     *  @brief  The same output as `print()`, formatted by `threads` threads
+     * (by default one per core), each of which computes its own elements.
+     *  @return The array itself.
+     */
+    inline _Self& print_parallel(int threads = 0,
+                                 char sep = ' ',
+                                 char end = '\n') {
+        CPGEN_PROFILE_SCOPE("LazyArray::print_parallel");
+        _out.write_seq_parallel(
+            n, [this](size_t i) { return _get(int(i) + 1); }, sep, end,
+            threads);
+        return *this;
+    }
+
+   private:
+    _Tp _lo{}, _hi{};
+    _Tp (*_func)(int) = nullptr;
+    int _begin = 1;
+    inline void _init(int size) {
+        if (size < 1)
+            throw GenException(
+                format("Invalid 'n' has been passed in `init`: %d", size));
+        n = size, _func = nullptr;
+        seed = _mix64(rnd.next(1ll << 62));
+    }
+    inline _Tp _get(int idx) const {
+        if (_func)
+            return _func(idx - 1 + _begin);
+        unsigned long long x = bits(idx);
+        if constexpr (std::is_floating_point<_Tp>::value) {
+            return _lo + (_hi - _lo) * _Tp((x >> 11) * 0x1.0p-53);
+        } else {
+            // Multiply-shift onto the span, its bias is below span / 2^64.
+            unsigned long long span =
+                (unsigned long long)_hi - (unsigned long long)_lo + 1;
+            if (span)
+                x = (__uint128_t)x * span >> 64;
+            return _Tp((unsigned long long)_lo + x);
+        }
+    }
+};
+
+/**
+ *  @brief  The operations of `Queries`, also the indexes of its `weights`
+ * and `codes`.
+ */
+enum class QueryType {
+    point_update,  ///< Printed as `code i v`.
+    range_update,  ///< Printed as `code l r v`.
+    range_query,   ///< Printed as `code l r`.
+};
+
+/**
+ *  @brief  How the intervals of `Queries` are chosen.
+ */
+enum class QueryLength {
+    uniform,         ///< \f$l\le r\f$ uniformly from \f$[1, n]\f$.
+    short_range,     ///< The length is at most \f$\sqrt n\f$.
+    long_range,      ///< The length is more than \f$n/2\f$.
+    full,            ///< Always \f$[1, n]\f$.
+    nested,          ///< Every interval is inside the previous one.
+    mo_adversary,    ///< Bad for Mo's algorithm with the block size `block`.
+    sqrt_adversary,  ///< Bad for sqrt decomposition with the block size
+                     ///< `block`.
+};
+
+/**
+ *  @brief  Class that used to generate the queries on an array, for segment
+ * tree, BIT, sqrt decomposition and Mo's algorithm problems:
+ * ```
+ * Array<int> arr;
+ * Queries<int> qs;
+ * _out.println(n, q);
+ * arr.basic_gen(n, 1, 1e9).print();
+ * qs.gen(n, q, 1, 1e9, {1, 0, 1}, QueryLength::short_range).print();
+ * ```
+ * Each interval takes a single draw of rnd, and both the generation and the
+ * output are \f$O(q)\f$.
+ */
+template <typename _Tp>
+class Queries {
+   public:
+    using _Self = Queries<_Tp>;
+    /**
+     *  @brief  One operation.
+     */
+    struct Query {
+        int l, r;       ///< The interval, \f$l=r\f$ for a point update.
+        _Tp value;      ///< The value of an update.
+        QueryType type;  ///< The kind of the operation.
+    };
+    int n = 0;                         ///< The size of the array.
+    int q = 0;                         ///< The count of the operations.
+    std::vector<Query> queries;        ///< The operations, 1-indexed.
+    std::array<int, 3> codes{1, 2, 3};  ///< The printed code of each type.
+    /**
+     *  @brief  Generate `count` operations on an array of size `size`.
+     *  @param  size the size of the array.
+     *  @param  count the count of the operations.
+     *  @param  wl, wr the range of the values of the updates.
+     *  @param  weights the relative frequency of point updates, range
+     * updates and range queries.
+     *  @param  length how the intervals are chosen.
+     *  @param  block the block size that the adversaries aim at. Default as
+     * \f$n/\sqrt q\f$ for Mo's algorithm and \f$\sqrt n\f$ for sqrt
+     * decomposition.
+     *  @return The queries themselves.
+     *  @throw  out_of_range if the weights are all zero.
+     */
+    inline _Self& gen(int size,
+                      int count,
+                      _Tp wl,
+                      _Tp wr,
+                      std::array<int, 3> weights = {1, 1, 1},
+                      QueryLength length = QueryLength::uniform,
+                      int block = 0) {
+        ensure(size >= 1 && count >= 0 && wl <= wr);
+        ensure(weights[0] >= 0 && weights[1] >= 0 && weights[2] >= 0);
+        int total = weights[0] + weights[1] + weights[2];
+        ensure(total > 0);
+        n = size, q = count;
+        if (queries.capacity() < size_t(q) + 1)
+            CPGEN_PROFILE_COUNT(allocs, 1),
+                CPGEN_PROFILE_COUNT(alloc_bytes, (q + 1) * sizeof(Query));
+        queries.resize(q + 1);
+        if (!block && length == QueryLength::mo_adversary)
+            block = std::max(1, int(n / std::sqrt(std::max(q, 1))));
+        if (!block)
+            block = std::max(1, int(std::sqrt(n)));
+        _nl = 1, _nr = n;
+        for (int i = 1; i <= q; i++) {
+            Query& qr = queries[i];
+            int t = total == weights[2] ? 2 : rnd.next(total);
+            if (t < weights[0]) {
+                qr.type = QueryType::point_update;
+                qr.l = qr.r = rnd.next(1, n);
+            } else {
+                qr.type = t < weights[0] + weights[1]
+                              ? QueryType::range_update
+                              : QueryType::range_query;
+                _interval(qr, length, block);
+            }
+            if (qr.type != QueryType::range_query)
+                qr.value = rnd.next(wl, wr);
+        }
+        return *this;
+    }
+    /**
+     *  @brief  Output the operations, one per line. NOTE that n and q will
+     * not be printed.
+     *  @return The queries themselves.
+     */
+    inline _Self& print() {
+        CPGEN_PROFILE_SCOPE("Queries::print");
+        _out.hold();
+        for (int i = 1; i <= q; i++) {
+            const Query& qr = queries[i];
+            if (qr.type == QueryType::point_update)
+                _out.println(codes[0], qr.l, qr.value);
+            else if (qr.type == QueryType::range_update)
+                _out.println(codes[1], qr.l, qr.r, qr.value);
+            else
+                _out.println(codes[2], qr.l, qr.r);
+        }
+        _out.release();
+        return *this;
+    }
+
+   private:
+    int _nl = 1, _nr = 1;  ///< The last interval of `QueryLength::nested`.
+    /**
+     *  @brief  Two numbers in \f$[0, a)\f$ and \f$[0, b)\f$ from one draw of
+     * rnd, by the multiply-shift reduction of two 31-bit halves.
+     */
+    static inline std::pair<int, int> _split(unsigned long long a,
+                                             unsigned long long b) {
+        unsigned long long x = rnd.next(1ll << 62);
+        return {int((x >> 31) * a >> 31), int((x & 0x7fffffff) * b >> 31)};
+    }
+    inline void _interval(Query& qr, QueryLength length, int block) {
+        if (length == QueryLength::full) {
+            qr.l = 1, qr.r = n;
+        } else if (length == QueryLength::short_range ||
+                   length == QueryLength::long_range) {
+            int lo = length == QueryLength::short_range ? 1 : n / 2 + 1;
+            int hi = length == QueryLength::short_range
+                         ? std::max(1, int(std::sqrt(n)))
+                         : n;
+            // The length comes from the high half, so the low half can be
+            // scaled by the count of the places of that length.
+            unsigned long long x = rnd.next(1ll << 62);
+            int len = lo + int((x >> 31) * (hi - lo + 1) >> 31);
+            qr.l = 1 + int((x & 0x7fffffff) * (n - len + 1) >> 31);
+            qr.r = qr.l + len - 1;
+        } else if (length == QueryLength::nested) {
+            int step = std::max(1, n / std::max(q, 1));
+            auto [a, b] = _split(2, step + 1);
+            if (a)
+                _nl = std::min(_nl + b, _nr);
+            else
+                _nr = std::max(_nr - b, _nl);
+            qr.l = _nl, qr.r = _nr;
+        } else if (length == QueryLength::mo_adversary) {
+            // Every block of l sweeps r over the rest of the array, and when
+            // sorted by r, l jumps between the two ends of its block.
+            int blocks = (n + block - 1) / block;
+            auto [k, b] = _split(blocks, n);
+            int lo = std::min(n, (k + 1) * block);
+            qr.r = lo + int(1ll * b * (n - lo + 1) / n);
+            qr.l = qr.r & 1 ? k * block + 1 : lo;
+        } else if (length == QueryLength::sqrt_adversary && n / block >= 2) {
+            // Both ends are just inside a block, so both partial blocks
+            // are scanned element by element, and half of the blocks are
+            // covered fully.
+            int blocks = n / block;
+            auto [k, j] = _split(blocks / 2, blocks - blocks / 2);
+            qr.l = k * block + std::min(2, block);
+            qr.r = (blocks / 2 + j) * block + block - 1;
+            qr.r = std::max(qr.r, qr.l);
+        } else {
+            auto [a, b] = _split(n, n);
+            qr.l = std::min(a, b) + 1, qr.r = std::max(a, b) + 1;
+        }
+    }
+};
+
+class Graph {
+   public:
+    using _Self = Graph;
+    int n = 0;                     ///< The count of points in the graph.
+    int m = 0;                     ///< The count of edges in the graph.
+    bool directed = false;  ///< Denoting if the **edges** are directed or not.
+    bool weighted = false;  ///< Denoting if the **edges** are weighted or not.
+    std::vector<pii> edges;       ///< The container of edges.
+    std::vector<i64_ll> weights;  ///< `weights[i]` is the weight of
+                                  ///< `edges[i]`. NOTE that it would be empty
+                                  ///< UNLESS the graph is weighted.
+
+    Graph() {}
+    Graph(const Tree& tr, bool direction = 0) {
+        n = tr.n, m = n - 1;
+        edges.reserve(m);
+        if (direction) {
+            for (int i = 2; i <= n; i++)
+                edges.push_back({i, tr.fa.at(i)});
+        } else {
+            for (int i = 2; i <= n; i++)
+                edges.push_back({tr.fa.at(i), i});
+        }
+    }
+    /**
+     *  @brief  Add a graph to the current graph. If either of them is
+     * weighted, the result is weighted, and the edges without weights get
+     * \f$0\f$.
+     *  @param  rhs the graph to be added.
+     *  @return The graph itself.
+     *  @throw  It throws what the _Sequence throws.
+     */
+    inline _Self& add(const Graph& rhs) {
+        int offset = n, count = rhs.edges.size();
+        n += rhs.n, m += rhs.m;
+        if (weighted || rhs.weighted)
+            weighted = true, weights.resize(edges.size(), 0);
+        for (int i = 0; i < count; i++)
+            if (weighted)
+                add_edge(offset + rhs.edges[i].first,
+                         offset + rhs.edges[i].second,
+                         rhs.weighted ? rhs.weights.at(i) : 0);
+            else
+                add_edge(offset + rhs.edges[i].first,
+                         offset + rhs.edges[i].second);
+        return *this;
+    }
+    inline Graph operator+(Graph rhs) {
+        Graph g = *this;
+        return g.add(rhs);
+    }
+    inline _Self& operator+=(const Graph& rhs) { return add(rhs); }
+    /**
+     *  @brief  init the whole graph with the size of `size`, and direct
+     * `directed_graph`.
+     *  @param  size how large this graph should be.
+     *  @param  directed_graph is this graph directed or not.
+     *  @return no return.
+     *  @throw  It throws what the std::vector throws.
+     */
+    void init(int size, bool directed_graph) {
+        if (size < 1)
+            throw GenException(
+                format("Invalid 'n' has been passed in `init`: %d", size));
+        n = size;
+        edges.clear(), weights.clear();
+        _index.clear(), _indexed = 0;
+        directed = directed_graph, weighted = false;
+    }
+    /**
+     *  @brief  Append the edge [u, v] to the graph. NOTE that this does NOT
+     * check whether the edge exists, use `exists()` first if it matters.
+     *  @param  u, v the point number of the edge.
+     *  @return no return.
+     */
+    inline void add_edge(int u, int v) { edges.push_back({u, v}); }
+    /**
+     *  @brief  Append the edge [u, v] with weight `w` to the graph, turning
+     * the graph into a weighted one.
+     *  @param  u, v the point number of the edge.
+     *  @param  w the weight of the edge.
+     *  @return no return.
+     */
+    inline void add_edge(int u, int v, i64_ll w) {
+        weighted = true;
+        edges.push_back({u, v}), weights.push_back(w);
+    }
+    /**
+     *  @brief  To check out if the edge exists or not. The edges appended
+     * since the last call are indexed lazily, so each edge is hashed once.
+     *  @param  u, v the point number of the edge that is being checked.
+     *  @return if the edge exists or not.
+     *  @throw  It throws what the std::vector throws.
+     */
+    inline bool exists(int u, int v) {
+        if (_indexed > edges.size() || _index.size() < 2 * edges.size() + 2) {
+            size_t size = 16;
+            while (size < 4 * edges.size() + 4)
+                size *= 2;
+            if (_index.capacity() < size)
+                CPGEN_PROFILE_COUNT(allocs, 1),
+                    CPGEN_PROFILE_COUNT(alloc_bytes, size * 8);
+            _index.assign(size, _empty), _indexed = 0;
+        }
+        for (; _indexed < edges.size(); _indexed++) {
+            unsigned long long key =
+                _key(edges[_indexed].first, edges[_indexed].second);
+            size_t i = _slot(key);
+            if (_index[i] == _empty)
+                _index[i] = key;
+        }
+        return _index[_slot(_key(u, v))] != _empty ||
+               (!directed && _index[_slot(_key(v, u))] != _empty);
+    }
+    /**
+     *  @brief  Randomly relabel the points of the graph, in \f$O(n+m)\f$.
+     *  @param  keep_first if point \f$1\f$ should keep its label, e.g. when it
+     * is the source of a shortest path problem.
+     *  @return The graph itself.
+     */
+    inline _Self& relabel(bool keep_first = true) {
+        auto label = _scratch<int>(n + 1);
+        std::iota(label.begin(), label.end(), 0);
+        label = _rnd.shuffle(std::move(label), keep_first ? 2 : 1);
+        for (pii& edge : edges)
+            edge = {label[edge.first], label[edge.second]};
+        _index.clear(), _indexed = 0;
+        return *this;
+    }
+    /**
+     *  @brief  Output the edges to stdout, one edge per line. NOTE that n and
+     * m will not be printed.
+     *  @param  shuffled if I should print it in random order.
+     *  @return The graph itself.
+     */
+    inline _Self& print(bool shuffled = false) {
+        CPGEN_PROFILE_SCOPE("Graph::print");
+        auto order = _scratch<int>(edges.size());
+        std::iota(order.begin(), order.end(), 0);
+        if (shuffled)
+            std::shuffle(order.begin(), order.end(), _rng_adapter());
+        _out.write_edges(order.size(), weighted, [&](size_t i) {
+            int j = order[i];
+            return std::array<i64_ll, 3>{edges[j].first, edges[j].second,
+                                         weighted ? weights[j] : 0};
+        });
+        return *this;
+    }
+    /**
+     *  @brief  Generate a graph completely random.
+     *  @param  size how large this graph should be.
+     *  @param  edges_count the count of the edges.
+     *  @param  directed_graph is this graph directed or not.
+     *  @return no return.
+     *  @throw  It throws what the std::vector throws.
+     */
+    inline _Self& randomly_gen(int size,
+                               int edges_count,
+                               bool directed_graph = false) {
+        CPGEN_PROFILE_SCOPE("Graph::randomly_gen");
+        init(size, directed_graph);
+        m = edges_count;
+        for (int i = 1; i <= edges_count; i++) {
+            int u = rnd.next(1, size), v = rnd.next(1, size);
+            CPGEN_PROFILE_COUNT(draws, 2);
+            if (!exists(u, v))
+                add_edge(u, v);
+            else
+                i--, CPGEN_PROFILE_COUNT(rejects, 1);
+        }
+        return *this;
+    }
+    /**
+     *  @brief  Generate a DAG.
+     *  @param  size how large this graph should be.
+     *  @param  edges_count the count of the edges.
+     *  @param  directed_graph is this graph directed or not.
+     *  @return no return.
+     *  @throw  It throws what the std::vector throws.
+     */
+    inline _Self& DAG(int size, int edges_count, bool ensure_connected = true) {
+        CPGEN_PROFILE_SCOPE("Graph::DAG");
+        init(size, true);
+        m = edges_count;
+        auto a = _scratch<int>(size + 1);
+        std::iota(a.begin(), a.end(), 0);
+        a = _rnd.shuffle(std::move(a));
+        if (ensure_connected) {
+            ensure(edges_count >= size - 1);
+            Tree tree;
+            tree.random_shaped_tree(size);
+            for (int i = 2; i <= size; i++) {
+                int u = tree.fa.at(i), v = i;
+                u < v ? add_edge(a[u], a[v]) : add_edge(a[v], a[u]);
+            }
+            edges_count -= (size - 1);
+        }
+        for (int i = 1; i <= edges_count; i++) {
+            int u = rnd.next(size - 1) + 1, v = u + rnd.next(size - u) + 1;
+            CPGEN_PROFILE_COUNT(draws, 2);
+            if (exists(a[u], a[v]))
+                i--, CPGEN_PROFILE_COUNT(rejects, 1);
+            else
+                add_edge(a[u], a[v]);
+        }
+        return *this;
+    }
+    /**
+     *  @brief  Generate a forest.
+     *  @param  size how large this graph should be.
+     *  @param  cnt the count of the trees.
+     *  @return no return.
+     *  @throw  It throws what the std::vector throws.
+     */
+
+    inline _Self& forest(int size, int cnt = -1) {
+        cnt = ~cnt ? cnt
+                   : rnd.next(1, std::min(std::max(size / 1000, 10), size));
+        Tree tr;
+        tr.random_shaped_tree(size);
+        auto perm = _scratch<int>(size + 1);
+        std::iota(perm.begin(), perm.end(), 0);
+        perm = _rnd.shuffle(std::move(perm));
+        auto cut = _scratch<char>(size + 1);
+        for (int i = 1; i <= cnt; i++)
+            cut[perm[i]] = 1;
+        init(size, false);
+        for (int i = 2; i <= size; i++)
+            if (!cut[i])
+                add_edge(tr.fa.at(i), i);
+        m = edges.size();
+        return *this;
+    }
+    /**
+     *  @brief  Generate a graph, on which spfa works so slow. The points form
+     * a grid of about \f$\sqrt n\f$ rows; edges along the rows are light
+     * and edges across the rows are heavy, so the queue keeps finding better
+     * distances for points it has already relaxed. Runs in \f$O(n+m)\f$.
+     *  @param  size how large this graph should be.
+     *  @param  edges_count the count of the edges, at least `size - 1`.
+     *  @param  hardness in \f$[0, 1]\f$, the gap between the weights: the
+     * light edges weigh at most \f$w^{1 - hardness}\f$, so \f$0\f$ gives
+     * uniform weights and \f$1\f$ light edges of weight \f$1\f$. For
+     * \f$n = 10^5, m = 1.5 \cdot 10^5\f$, spfa relaxes about \f$2 \cdot
+     * 10^6\f$ times at \f$0\f$ and \f$4 \cdot 10^8\f$ at \f$1\f$.
+     *  @param  directed_graph is this graph directed or not.
+     *  @param  max_weight the sup of the weights.
+     *  @return The graph itself, with the source at point \f$1\f$.
+     *  @throw  It throws what the std::vector throws.
+     */
+    inline _Self& hack_spfa(int size,
+                            int edges_count,
+                            double hardness = 1.0,
+                            bool directed_graph = false,
+                            i64_ll max_weight = 1000000000) {
+        CPGEN_PROFILE_SCOPE("Graph::hack_spfa");
+        ensure(size >= 2 && edges_count >= size - 1);
+        ensure(0 <= hardness && hardness <= 1 && max_weight >= 1);
+        init(size, directed_graph);
+        m = edges_count;
+        int rows = std::max(1, std::min<int>(std::sqrt(size), size / 2));
+        int cols = size / rows;
+        i64_ll light =
+            std::max(1ll, std::llround(std::pow(max_weight, 1 - hardness)));
+        auto id = [&](int i, int j) { return i * cols + j + 1; };
+        for (int i = 0; i < rows; i++)
+            for (int j = 1; j < cols; j++)
+                add_edge(id(i, j - 1), id(i, j), rnd.next(1ll, light));
+        for (int i = 1; i < rows; i++)
+            add_edge(id(i - 1, 0), id(i, 0), rnd.next(1ll, max_weight));
+        for (int i = rows * cols + 1; i <= size; i++)
+            add_edge(i - 1, i, rnd.next(1ll, max_weight));
+        // Selection sampling over the remaining vertical slots.
+        long long slots = 1ll * (rows - 1) * (cols - 1);
+        long long need = std::min<long long>(slots, edges_count - m_now());
+        for (int i = 1; i < rows; i++)
+            for (int j = 1; j < cols; j++, slots--)
+                if (rnd.next(slots) < need)
+                    add_edge(id(i - 1, j), id(i, j), rnd.next(1ll, max_weight)),
+                        need--;
+        _add_random_edges(edges_count - m_now(), max_weight, max_weight);
+        return relabel(true);
+    }
+    /**
+     *  @brief  Generate a graph on which Bellman-Ford needs many rounds. The
+     * shortest path tree is a chain whose edges are listed block by block in
+     * reverse order, so a round with early termination settles only one
+     * block. The other edges are never on a shortest path, but some are only
+     * slightly longer, which makes SPFA relax points repeatedly. Runs in
+     * \f$O(n+m)\f$.
+     *  @param  size how large this graph should be.
+     *  @param  edges_count the count of the edges, at least `size - 1`.
+     *  @param  hardness in \f$[0, 1]\f$. About `hardness * size` rounds are
+     * needed, and the other edges get closer to the shortest paths as it
+     * grows.
+     *  @param  directed_graph is this graph directed or not.
+     *  @param  max_weight the sup of the weights, at least \f$2\f$.
+     *  @return The graph itself, with the source at point \f$1\f$.
+     *  @throw  It throws what the std::vector throws.
+     */
+    inline _Self& hack_bellman_ford(int size,
+                                    int edges_count,
+                                    double hardness = 1.0,
+                                    bool directed_graph = true,
+                                    i64_ll max_weight = 1000000000) {
+        CPGEN_PROFILE_SCOPE("Graph::hack_bellman_ford");
+        ensure(size >= 2 && edges_count >= size - 1);
+        ensure(0 <= hardness && hardness <= 1 && max_weight >= 2);
+        init(size, directed_graph);
+        m = edges_count;
+        i64_ll chain_weight = std::max(1ll, max_weight / size);
+        i64_ll gap =
+            std::max(1ll, std::llround(max_weight / 2 * (1 - hardness)));
+        auto dis = _scratch<i64_ll>(size + 1), w = _scratch<i64_ll>(size + 1);
+        for (int i = 2; i <= size; i++)
+            w[i] = rnd.next(1ll, chain_weight), dis[i] = dis[i - 1] + w[i];
+        int blocks = std::max(1, int(std::lround(hardness * (size - 1))));
+        int len = (size - 1 + blocks - 1) / blocks;
+        for (int r = size; r >= 2; r -= len)
+            for (int i = std::max(2, r - len + 1); i <= r; i++)
+                add_edge(i - 1, i, w[i]);
+        int reach =
+            std::min<i64_ll>((max_weight - gap) / chain_weight, size - 1);
+        // The pairs at distance at most `reach`, the chain included.
+        long long pairs = 1ll * reach * size - 1ll * reach * (reach + 1) / 2;
+        ensure(edges_count <= pairs * (directed_graph ? 2 : 1));
+        for (int i = m_now(); i < edges_count; i++) {
+            int u = rnd.next(1, size);
+            int v = rnd.next(std::max(1, u - reach), std::min(size, u + reach));
+            if (u == v || exists(u, v)) {
+                i--;
+                continue;
+            }
+            i64_ll base =
+                directed_graph && v < u ? 0 : std::abs(dis[v] - dis[u]);
+            add_edge(u, v, base + rnd.next(1ll, gap));
+        }
+        return relabel(true);
+    }
+    /**
+     *  @brief  Generate a graph on which heap-based Dijkstra performs a
+     * decrease-key (or pushes a new entry with lazy deletion) for nearly every
+     * edge. Point \f$1\f$ reaches \f$k\f$ hubs at increasing distance, and
+     * every hub offers a shorter path to the same \f$t\f$ targets than the
+     * previous one, so the heap grows to \f$kt\f$ entries. Runs in
+     * \f$O(n+m)\f$.
+     *  @param  size how large this graph should be.
+     *  @param  edges_count the count of the edges, at least `size - 1`.
+     *  @param  hardness in \f$[0, 1]\f$, the part of the edges spent on the
+     * hubs and targets. The rest are heavy random edges.
+     *  @param  directed_graph is this graph directed or not.
+     *  @param  max_weight the sup of the weights, at least \f$5\f$.
+     *  @return The graph itself, with the source at point \f$1\f$.
+     *  @throw  It throws what the std::vector throws.
+     */
+    inline _Self& hack_dijkstra(int size,
+                                int edges_count,
+                                double hardness = 1.0,
+                                bool directed_graph = true,
+                                i64_ll max_weight = 1000000000) {
+        CPGEN_PROFILE_SCOPE("Graph::hack_dijkstra");
+        ensure(size >= 3 && edges_count >= size - 1);
+        ensure(0 <= hardness && hardness <= 1 && max_weight >= 5);
+        init(size, directed_graph);
+        m = edges_count;
+        long long budget = std::llround(hardness * (edges_count - (size - 1)));
+        int hubs = std::min<long long>({(long long)std::sqrt(budget) + 1,
+                                        (size - 1) / 2, (max_weight - 1) / 2});
+        hubs = std::max(hubs, 1);
+        int targets = size - 1 - hubs;
+        if (hubs > 1)
+            targets = std::min<long long>(targets, budget / (hubs - 1));
+        for (int i = 1; i <= hubs; i++)
+            add_edge(1, i + 1, i);
+        for (int i = 1; i <= hubs; i++)
+            for (int j = 1; j <= targets; j++)
+                add_edge(i + 1, hubs + 1 + j, max_weight - 2 * i);
+        for (int i = hubs + targets + 2; i <= size; i++)
+            add_edge(rnd.next(1, i - 1), i, rnd.next(1ll, max_weight));
+        _add_random_edges(edges_count - m_now(), max_weight, max_weight);
+        return relabel(true);
+    }
+    /**
+     *  @brief  Generate a random bipartite graph, whose left part is
+     * \f$[1, l]\f$ and right part is \f$[l+1, l+r]\f$. When more than half of
+     * the pairs are wanted, the missing pairs are sampled instead, so it runs
+     * in \f$O(n+m)\f$ expected time.
+     *  @param  left_size, right_size the sizes of the two parts.
+     *  @param  edges_count the count of the edges.
+     *  @param  directed_graph is this graph directed (from left to right) or
+     * not.
+     *  @return The graph itself.
+     *  @throw  It throws what the std::unordered_set throws.
+     */
+    inline _Self& bipartite(int left_size,
+                            int right_size,
+                            int edges_count,
+                            bool directed_graph = false) {
+        long long pairs = 1ll * left_size * right_size;
+        ensure(left_size >= 1 && right_size >= 1);
+        ensure(0 <= edges_count && edges_count <= pairs);
+        init(left_size + right_size, directed_graph);
+        m = edges_count;
+        if (edges_count <= pairs / 2) {
+            for (int i = 1; i <= edges_count; i++) {
+                int u = rnd.next(1, left_size),
+                    v = left_size + rnd.next(1, right_size);
+                if (exists(u, v))
+                    i--;
+                else
+                    add_edge(u, v);
+            }
+            return *this;
+        }
+        std::unordered_set<unsigned long long> missing;
+        while ((long long)missing.size() < pairs - edges_count)
+            missing.insert(_key(rnd.next(1, left_size),
+                                left_size + rnd.next(1, right_size)));
+        edges.reserve(edges_count);
+        for (int u = 1; u <= left_size; u++)
+            for (int v = left_size + 1; v <= n; v++)
+                if (!missing.count(_key(u, v)))
+                    add_edge(u, v);
+        std::shuffle(edges.begin(), edges.end(), _rng_adapter());
+        return *this;
+    }
+    /**
+     *  @brief  Generate a random simple \f$d\f$-regular graph. Stubs are
+     * paired by the configuration model, then every self-loop or multiple
+     * edge is removed by switching it with a random edge; if the switches
+     * get stuck, it starts again. A dense graph, \f$d > (n-1)/2\f$, is the
+     * complement of a random \f$(n-1-d)\f$-regular graph, as the switches
+     * hardly find a free pair in it.
+     *  @param  size how large this graph should be.
+     *  @param  degree the degree \f$d\f$ of every point. `size * degree`
+     * should be even.
+     *  @return The graph itself.
+     *  @throw  It throws what the std::vector throws.
+     */
+    inline _Self& regular(int size, int degree) {
+        ensure(0 <= degree && degree < size && 1ll * size * degree % 2 == 0);
+        if (degree > (size - 1) / 2) {
+            regular(size, size - 1 - degree)._complement();
+            return *this;
+        }
+        while (!_configuration(size, degree))
+            CPGEN_PROFILE_COUNT(rejects, 1);
+        return *this;
+    }
+    /**
+     *  @brief  Generate a random cactus, in which every edge is on at most
+     * one simple cycle. Each step hangs either a bridge or a new cycle on a
+     * random existing point, so it runs in \f$O(n)\f$.
+     *  @param  size how large this graph should be.
+     *  @param  cycle_percent the chance that a step adds a cycle.
+     *  @param  max_cycle the sup of the cycle length. Default as
+     * \f$\max(3, \sqrt n)\f$.
+     *  @return The graph itself.
+     *  @throw  It throws what the std::vector throws.
+     */
+    inline _Self& cactus(int size,
+                         double cycle_percent = 0.5,
+                         int max_cycle = -1) {
+        init(size, false);
+        max_cycle = ~max_cycle ? max_cycle : std::max(3, int(std::sqrt(size)));
+        ensure(max_cycle >= 3 && 0 <= cycle_percent && cycle_percent <= 1);
+        for (int cur = 1; cur < size;) {
+            int anchor = rnd.next(1, cur), rest = size - cur;
+            if (rest >= 2 && rnd.next() < cycle_percent) {
+                int len = rnd.next(3, std::min(max_cycle, rest + 1));
+                add_edge(anchor, cur + 1);
+                for (int i = 2; i < len; i++)
+                    add_edge(cur + i - 1, cur + i);
+                add_edge(cur + len - 1, anchor);
+                cur += len - 1;
+            } else {
+                add_edge(anchor, ++cur);
+            }
+        }
+        m = edges.size();
+        return relabel(false);
+    }
+    /**
+     *  @brief  Generate a random planar graph: a grid with
+     * \f$\lceil\sqrt n\rceil\f$ columns (the last row may be partial), in
+     * which some cells get one of their two diagonals.
+     *  @param  size how large this graph should be.
+     *  @param  diagonals_count how many cells get a diagonal. Default as a
+     * random number.
+     *  @return The graph itself.
+     *  @throw  It throws what the std::vector throws.
+     */
+    inline _Self& planar(int size, int diagonals_count = -1) {
+        init(size, false);
+        int cols = std::ceil(std::sqrt(size)), rows = (size + cols - 1) / cols;
+        auto id = [&](int i, int j) { return i * cols + j + 1; };
+        long long cells = 1ll * (size / cols - 1) * (cols - 1);
+        for (int j = 0; j + 1 < size % cols; j++)
+            cells += rows > 1;
+        cells = std::max(cells, 0ll);
+        diagonals_count =
+            ~diagonals_count ? diagonals_count : int(rnd.next(0ll, cells));
+        ensure(0 <= diagonals_count && diagonals_count <= cells);
+        long long need = diagonals_count;
+        for (int i = 0; i < rows; i++)
+            for (int j = 0; j < cols && id(i, j) <= size; j++) {
+                if (j)
+                    add_edge(id(i, j - 1), id(i, j));
+                if (i)
+                    add_edge(id(i - 1, j), id(i, j));
+                if (i && j && rnd.next(cells--) < need) {
+                    need--;
+                    if (rnd.next(2))
+                        add_edge(id(i - 1, j - 1), id(i, j));
+                    else
+                        add_edge(id(i - 1, j), id(i, j - 1));
+                }
+            }
+        m = edges.size();
+        return relabel(false);
+    }
+    /**
+     *  @brief  Generate a random tournament, that is, every pair of points is
+     * connected by exactly one directed edge. Runs in \f$O(n^2)\f$, which is
+     * \f$O(m)\f$.
+     *  @param  size how large this graph should be.
+     *  @return The graph itself.
+     *  @throw  It throws what the std::vector throws.
+     */
+    inline _Self& tournament(int size) {
+        init(size, true);
+        m = 1ll * size * (size - 1) / 2;
+        edges.reserve(m);
+        int bits = 0, left = 0;
+        for (int u = 1; u <= size; u++)
+            for (int v = u + 1; v <= size; v++) {
+                if (!left)
+                    bits = rnd.next(1 << 30), left = 30;
+                (bits >> --left & 1) ? add_edge(u, v) : add_edge(v, u);
+            }
+        return relabel(false);
+    }
+
+   private:
+    /// Keys of `edges`, in an open addressing table that is reused by the
+    /// next generation, so checking an edge never allocates.
+    std::vector<unsigned long long> _index;
+    size_t _indexed = 0;  ///< how many edges are already in `_index`.
+    static constexpr unsigned long long _empty = ~0ull;
+    /**
+     *  @brief  The slot in `_index` that holds `key`, or the empty slot where
+     * it should be, using linear probing.
+     */
+    inline size_t _slot(unsigned long long key) const {
+        size_t mask = _index.size() - 1;
+        size_t i = (key * 0x9e3779b97f4a7c15ull) >> 32 & mask;
+        while (_index[i] != _empty && _index[i] != key)
+            i = (i + 1) & mask;
+        return i;
+    }
+    static inline unsigned long long _key(int u, int v) {
+        return (unsigned long long)(unsigned)u << 32 | (unsigned)v;
+    }
+    inline int m_now() { return edges.size(); }
+    /**
+     *  @brief  One try of `regular()`.
+     *  @return If the switches removed every self-loop and multiple edge.
+     */
+    inline bool _configuration(int size, int degree) {
+        init(size, false);
+        m = 1ll * size * degree / 2;
+        auto stubs = _scratch<int>(2 * m);
+        for (int i = 0; i < 2 * m; i++)
+            stubs[i] = i / degree + 1;
+        std::shuffle(stubs.begin(), stubs.end(), _rng_adapter());
+        // `nb` holds the `degree` neighbours of every point in a flat array.
+        auto nb = _scratch<int>(2 * m), filled = _scratch<int>(size + 1);
+        auto neighbours = [&](int u) {
+            return nb.begin() + 1ll * (u - 1) * degree;
+        };
+        auto mult = [&](int u, int v) {
+            return std::count(neighbours(u), neighbours(u) + degree, v);
+        };
+        auto replace = [&](int u, int from, int to) {
+            *std::find(neighbours(u), neighbours(u) + degree, from) = to;
+        };
+        for (int i = 0; i < m; i++) {
+            int u = stubs[2 * i], v = stubs[2 * i + 1];
+            add_edge(u, v);
+            neighbours(u)[filled[u]++] = v, neighbours(v)[filled[v]++] = u;
+        }
+        auto bad = _scratch<int>();
+        for (int i = 0; i < m; i++)
+            if (edges[i].first == edges[i].second ||
+                mult(edges[i].first, edges[i].second) > 1)
+                bad.push_back(i);
+        long long tries = 100ll * (m + 1);
+        while (!bad.empty()) {
+            if (tries-- <= 0)
+                return false;
+            int i = bad.back(), j = rnd.next(m);
+            auto [a, b] = edges[i];
+            if (a != b && mult(a, b) == 1) {
+                bad.pop_back();
+                continue;
+            }
+            auto [c, d] = edges[j];
+            if (rnd.next(2))
+                std::swap(c, d);
+            if (i == j || a == c || b == d || (a == d && b == c) ||
+                (a == b && c == d) || mult(a, c) || mult(b, d))
+                continue;
+            replace(a, b, c), replace(b, a, d);
+            replace(c, d, a), replace(d, c, b);
+            edges[i] = {a, c}, edges[j] = {b, d};
+            bad.pop_back();
+        }
+        return true;
+    }
+    /**
+     *  @brief  Replace the simple undirected graph by its complement, in
+     * \f$O(n^2)\f$ time, and shuffle the edges.
+     */
+    inline void _complement() {
+        auto head = _scratch<int>(n + 2), adj = _scratch<int>(2 * m);
+        for (const pii& e : edges)
+            head[e.first]++, head[e.second]++;
+        for (int i = 1; i <= n + 1; i++)
+            head[i] += head[i - 1];
+        for (const pii& e : edges)
+            adj[--head[e.first]] = e.second, adj[--head[e.second]] = e.first;
+        auto mark = _scratch<char>(n + 1);
+        std::vector<pii> res;
+        res.reserve(1ll * n * (n - 1) / 2 - m);
+        for (int u = 1; u <= n; u++) {
+            for (int j = head[u]; j < head[u + 1]; j++)
+                mark[adj[j]] = 1;
+            for (int v = u + 1; v <= n; v++)
+                if (!mark[v])
+                    res.push_back({u, v});
+            for (int j = head[u]; j < head[u + 1]; j++)
+                mark[adj[j]] = 0;
+        }
+        edges.swap(res), m = edges.size();
+        _index.clear(), _indexed = 0;
+        std::shuffle(edges.begin(), edges.end(), _rng_adapter());
+    }
     /**
-     *  @brief  Shuffle the current array.
-     *  @throw  It throws what the _Sequence throws.
+     *  @brief  Append `count` random edges that are neither self-loops nor
+     * duplicates, with weights in \f$[wl, wr]\f$.
      */
-    inline void shuffle() { _rnd.shuffle(array); }
+    inline void _add_random_edges(int count, i64_ll wl, i64_ll wr) {
+        long long cap = 1ll * n * (n - 1) / (directed ? 1 : 2);
+        ensure((long long)edges.size() + count <= cap);
+        for (int i = 1; i <= count; i++) {
+            int u = rnd.next(1, n), v = rnd.next(1, n);
+            CPGEN_PROFILE_COUNT(draws, 2);
+            if (u == v || exists(u, v))
+                i--, CPGEN_PROFILE_COUNT(rejects, 1);
+            else
+                add_edge(u, v, rnd.next(wl, wr));
+        }
+    }
     /**
-     *  @brief  Reverse the current array.
-     *  @throw  It throws what the _Sequence throws.
+     *  @brief  Adapt rnd to the UniformRandomBitGenerator of <algorithm>.
      */
-    inline void reverse() { std::reverse(array.begin(), array.end()); }
+    struct _rng_adapter {
+        using result_type = unsigned int;
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return 0x7fffffff; }
+        result_type operator()() { return rnd.next(0, 0x7fffffff); }
+    };
+};
+
+/**
+ *  @brief  Class that enumerates all the simple undirected graphs of size
+ * \f$n \le 8\f$ up to isomorphism, each exactly once (\f$12346\f$ graphs for
+ * \f$n = 8\f$). No successor visits one graph per class in constant time, so
+ * `init()` builds the classes point by point, keeping one canonical form of
+ * each, and `next()` writes the next one into `graph` in \f$O(m)\f$:
+ * ```
+ * GraphClasses all;
+ * all.init(6, true);  // the 112 connected graphs
+ * do
+ *     _out.println(all.graph.n, all.graph.m), all.graph.print();
+ * while (all.next());
+ * ```
+ */
+class GraphClasses {
+   public:
+    using _Self = GraphClasses;
+    Graph graph;  ///< The current graph.
     /**
-     *  @brief  Turn this array into the Diffrence array of it.
-     *  @return The array itself.
-     *  @throw  It throws what the _Sequence throws.
+     *  @brief  Find the classes of size `size`, and start from the first.
+     *  @param  size the count of points, in \f$[1, 8]\f$.
+     *  @param  connected_only if only the connected graphs are enumerated.
+     *  @return The enumerator itself.
+     *  @throw  Throws GenException if @a size is not in \f$[1, 8]\f$.
      */
-    inline _Self to_diffrence() {
-        for (int i = n; i >= 1; i--)
-            array.at(i) -= array.at(i - 1);
+    inline _Self& init(int size, bool connected_only = false) {
+        if (size < 1 || size > 8)
+            throw GenException(format(
+                "Invalid 'n' has been passed in `GraphClasses`: %d", size));
+        _n = size;
+        // Each class of k + 1 points is some class of k points with a new
+        // point, so extend the classes of k points by every neighbourhood.
+        std::vector<unsigned> now{0}, found;
+        std::unordered_set<unsigned> seen;
+        for (int k = 1; k < size; k++) {
+            found.clear(), seen.clear();
+            for (unsigned code : now)
+                for (unsigned s = 0; s < (1u << k); s++) {
+                    unsigned c = _canonical(k + 1, code | s << k * (k - 1) / 2);
+                    if (seen.insert(c).second)
+                        found.push_back(c);
+                }
+            now.swap(found);
+        }
+        _codes.clear();
+        for (unsigned code : now)
+            if (!connected_only || _connected(code))
+                _codes.push_back(code);
+        std::sort(_codes.begin(), _codes.end());
+        _cur = 0, _decode();
         return *this;
     }
     /**
-     *  @brief  Generate an array with size `size`, while its elements are 0
-     * or 1.
-     *  @param  size how large this array should be.
-     *  @return The array itself.
-     *  @throw  It throws what the _Sequence throws.
+     *  @brief  The count of the classes.
      */
-    inline _Self binary_gen(int size) { return basic_gen(size, 0, 1); }
+    inline size_t count() const { return _codes.size(); }
     /**
-     *  @brief  Generate an array with size `size`, while its elements are not
-     * decreasing.
-     *  @param  size how large this array should be.
-     *  @param  wl the sub of the elements.
-     *  @param  wr the sup of the elements.
-     *  @return The array itself.
-     *  @throw  It throws what the _Sequence throws.
+     *  @brief  Step to the next graph.
+     *  @return If there is a next graph. Otherwise `graph` is back to the
+     * first one.
      */
-    inline _Self ascending_array(int size, _Tp wl, _Tp wr) {
-        init(size);
-        basic_gen(size, wl, wr);
-        (*this).sort(), (*this).shuffle();
-        return *this;
+    inline bool next() {
+        bool more = ++_cur < _codes.size();
+        if (!more)
+            _cur = 0;
+        _decode();
+        return more;
+    }
+
+   private:
+    int _n = 0;
+    size_t _cur = 0;
+    /// The canonical forms, the edge \f$(u, v)\f$ with \f$u < v\f$ is the
+    /// bit \f$(v - 1)(v - 2) / 2 + u - 1\f$.
+    std::vector<unsigned> _codes;
+    inline void _decode() {
+        unsigned code = _codes[_cur];
+        graph.init(_n, false);
+        for (int v = 2, b = 0; v <= _n; v++)
+            for (int u = 1; u < v; u++, b++)
+                if (code >> b & 1)
+                    graph.add_edge(u, v);
+        graph.m = graph.edges.size();
     }
     /**
-     *  @brief  Generate an array with size `size`, while its elements are not
-     * increasing.
-     *  @param  size how large this array should be.
-     *  @param  wl the sub of the elements.
-     *  @param  wr the sup of the elements.
-     *  @return The array itself.
-     *  @throw  It throws what the _Sequence throws.
+     *  @brief  Read a code into the adjacency bitsets, 0-indexed.
      */
-    inline _Self decending_array(int size, _Tp wl, _Tp wr) {
-        ascending_array(size, wl, wr);
-        reverse();
-        return *this;
+    static inline void _unpack(int k, unsigned code, unsigned adj[]) {
+        std::fill(adj, adj + k, 0u);
+        for (int v = 1, b = 0; v < k; v++)
+            for (int u = 0; u < v; u++, b++)
+                if (code >> b & 1)
+                    adj[u] |= 1u << v, adj[v] |= 1u << u;
     }
     /**
-     *  @brief  Generate an array with size `size`, while the sum of its
-     * elements are a constant.
-     *  @param  size how large this array should be.
-     *  @param  sum the sum of the elements.
-     *  @param  AcceptZero if the array can contain zero or not.
-     *  @param  AcceptNegative if the array can contain negative values or not.
-     *  @return The array itself.
-     *  @throw  It throws what the _Sequence throws.
+     *  @brief  The max code over the relabellings that sort the points by an
+     * invariant (the degree, refined by the degrees of the neighbours). The
+     * order of the points within each tie is tried exhaustively.
      */
-    inline _Self constant_sum(int size,
-                              _Tp sum,
-                              bool AcceptZero = true,
-                              bool AcceptNegative = true) {
-        init(size);
-        if (AcceptZero)
-            basic_gen(size - 1, 0, sum), array.at(size) = sum;
-        else
-            sum > n ? basic_gen(size - 1, 0, sum - n)
-                    : basic_gen(size - 1, size - n, 0),
-                array.at(size) = sum - n;
-        (AcceptNegative ? void(nullptr) : sort()), to_diffrence();
-        if (!AcceptZero) {
-            for (int i = 1; i <= size; i++)
-                array.at(i)++;
+    static inline unsigned _canonical(int k, unsigned code) {
+        unsigned adj[8];
+        unsigned long long key[8], next_key[8];
+        _unpack(k, code, adj);
+        for (int v = 0; v < k; v++)
+            key[v] = __builtin_popcount(adj[v]);
+        for (int round = 0; round < 2; round++) {
+            for (int v = 0; v < k; v++) {
+                unsigned long long sum = 0;
+                for (int u = 0; u < k; u++)
+                    if (adj[v] >> u & 1) {
+                        unsigned long long h = key[u] * 0x9e3779b97f4a7c15ull;
+                        sum += h ^ h >> 29;
+                    }
+                next_key[v] = key[v] * 0x100000001b3ull + sum;
+            }
+            std::copy(next_key, next_key + k, key);
+        }
+        int ord[8];
+        for (int i = 0; i < k; i++) {
+            int j = i;
+            for (; j > 0 && key[ord[j - 1]] > key[i]; j--)
+                ord[j] = ord[j - 1];
+            ord[j] = i;
+        }
+        int cell[8];  ///< `cell[i]` is where the tie of `ord[i]` starts.
+        for (int i = 0; i < k; i++)
+            cell[i] = i && key[ord[i]] == key[ord[i - 1]] ? cell[i - 1] : i;
+        unsigned best = 0;
+        for (;;) {
+            unsigned c = 0;
+            for (int v = 1, b = 0; v < k; v++)
+                for (int u = 0; u < v; u++, b++)
+                    c |= (adj[ord[u]] >> ord[v] & 1u) << b;
+            best = std::max(best, c);
+            // Step the permutations of the ties like an odometer.
+            int end = k;
+            while (end > 0 &&
+                   !std::next_permutation(ord + cell[end - 1], ord + end))
+                end = cell[end - 1];
+            if (end == 0)
+                return best;
         }
-        return *this;
     }
+    inline bool _connected(unsigned code) const {
+        unsigned adj[8], seen = 1, last = 0;
+        _unpack(_n, code, adj);
+        while (seen != last) {
+            last = seen;
+            for (int v = 0; v < _n; v++)
+                if (last >> v & 1)
+                    seen |= adj[v];
+        }
+        return seen == (1u << _n) - 1;
+    }
+};
+
+/**
+ *  @brief  The operations of the dynamic streams, also the indexes of their
+ * `weights` and `codes`.
+ */
+enum class EdgeOp {
+    add,     ///< Link or insert the edge \f$(u, v)\f$.
+    remove,  ///< Cut or delete the edge \f$(u, v)\f$.
+    query,   ///< Ask about the points \f$u, v\f$.
+};
+
+/**
+ *  @brief  One operation of a dynamic stream.
+ */
+struct Operation {
+    EdgeOp type;
+    int u, v;
+};
+
+/**
+ *  @brief  Class that used to generate link/cut operations that keep a
+ * forest valid: `add` only links two trees, and `remove` only cuts an edge
+ * of the forest. Every tree has one representative point, kept by a
+ * link-cut tree that counts the representatives in each tree: a point of
+ * the tree at the start, or an end of the last edge cut in it. A link joins
+ * a uniform point \f$u\f$ with the representative of another tree, drawn
+ * uniformly from the representatives until it is not in the tree of
+ * \f$u\f$, which takes at most 2 draws expected as there are at least 2
+ * trees. So the links are not uniform over the valid pairs: every other
+ * tree is as likely as any, whatever its size, and is hung by its
+ * representative. Each operation takes \f$O(\log n)\f$ amortized time.
+ * ```
+ * Tree tree;
+ * DynamicForest df;
+ * df.init(tree.random_shaped_tree(n)).gen(q, {1, 1, 2}, true).print();
+ * ```
+ */
+class DynamicForest {
+   public:
+    using _Self = DynamicForest;
+    int n = 0;                     ///< The count of points.
+    int q = 0;                     ///< The count of the operations.
+    std::vector<Operation> ops;    ///< The operations, 1-indexed.
+    std::vector<pii> edges;        ///< The edges of the forest now.
+    std::array<int, 3> codes{1, 2, 3};  ///< The printed code of each type.
     /**
-     *  @brief  Perturbe the current array, keeping the sum of the elements
-     * still.
-     *  @return The array itself.
-     *  @throw  It throws what the _Sequence throws.
+     *  @brief  Start from \f$n\f$ isolated points.
+     *  @param  size the count of points.
+     *  @return The stream itself.
+     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
      */
-    inline _Self perturbe() {
-        Array<_Tp> tmp_arr;
-        tmp_arr.constant_sum(n, 0);
+    inline _Self& init(int size) {
+        if (size < 1)
+            throw GenException(
+                format("Invalid 'n' has been passed in `init`: %d", size));
+        n = size, q = 0;
+        ops.assign(1, {EdgeOp::query, 0, 0}), edges.clear();
+        _ch.assign(n + 1, {0, 0}), _fa.assign(n + 1, 0);
+        _rev.assign(n + 1, 0), _val.assign(n + 1, 1), _sum.assign(n + 1, 1);
+        _virt.assign(n + 1, 0), _val[0] = _sum[0] = 0;
+        _reps.resize(n), _pos.resize(n + 1);
         for (int i = 1; i <= n; i++)
-            array.at(i) += tmp_arr.at(i);
+            _reps[i - 1] = i, _pos[i] = i - 1;
         return *this;
     }
     /**
-     *  @brief  Generate a permutation of 1 to size.
-     *  @param  size the size of the array.
-     *  @return The array itself.
-     *  @throw  It throws what the _Sequence throws.
+     *  @brief  Start from the edges of `tr`.
+     *  @return The stream itself.
      */
-    inline _Self permutation(int size) {
-        init(size);
-        array = rnd.perm(size, 1);
+    inline _Self& init(const Tree& tr) {
+        init(tr.n);
+        for (int i = 1; i <= n; i++)
+            if (tr.fa.at(i))
+                _unmark(i), _link(i, tr.fa[i]), edges.push_back({tr.fa[i], i});
         return *this;
     }
     /**
-     *  @brief  Generate an array with the i-th element is f(i + begin).
-     *  @param  size the size of the array.
-     *  @param  GenerateFunction the GenerateFunction of the array.
-     *  @param  begin the begin point of the array.
-     *  @return The array itself.
-     *  @throw  It throws what the _Sequence throws.
+     *  @brief  Append `count` operations.
+     *  @param  count the count of the operations.
+     *  @param  weights the relative frequency of links, cuts and queries.
+     * When a link is impossible (the forest is a tree), a cut is made
+     * instead, and vice versa.
+     *  @param  connected_queries if \f$u, v\f$ of the queries should be in
+     * the same tree, e.g. for path queries.
+     *  @return The stream itself.
+     *  @throw  out_of_range if the weights are all zero.
      */
-    inline _Self generate_function(int size,
-                                   int (*GenerateFunction)(int),
-                                   int begin = 1) {
-        init(size);
-        for (int i = 0; i < size; i++)
-            array.at(i + 1) = GenerateFunction(i + begin);
+    inline _Self& gen(int count,
+                      std::array<int, 3> weights = {1, 1, 1},
+                      bool connected_queries = false) {
+        CPGEN_PROFILE_SCOPE("DynamicForest::gen");
+        int total = weights[0] + weights[1] + weights[2];
+        ensure(n >= 1 && count >= 0 && total > 0);
+        ensure(weights[0] >= 0 && weights[1] >= 0 && weights[2] >= 0);
+        ops.reserve(q + count + 1);
+        for (int i = 1; i <= count; i++) {
+            int t = rnd.next(total), u, v;
+            EdgeOp type = t < weights[0]              ? EdgeOp::add
+                          : t < weights[0] + weights[1] ? EdgeOp::remove
+                                                        : EdgeOp::query;
+            if (type == EdgeOp::add && _reps.size() == 1)
+                type = n > 1 ? EdgeOp::remove : EdgeOp::query;
+            if (type == EdgeOp::remove && edges.empty())
+                type = n > 1 ? EdgeOp::add : EdgeOp::query;
+            if (type == EdgeOp::add) {
+                // v is the representative of another tree, drawn until it
+                // is not in the tree of u, and no longer a representative
+                // after the link.
+                u = rnd.next(1, n);
+                do
+                    v = _reps[rnd.next(int(_reps.size()))],
+                    CPGEN_PROFILE_COUNT(draws, 2);
+                while (_connected(u, v));
+                _unmark(v), _link(u, v), edges.push_back({u, v});
+            } else if (type == EdgeOp::remove) {
+                int idx = rnd.next(int(edges.size()));
+                std::tie(u, v) = edges[idx];
+                edges[idx] = edges.back(), edges.pop_back();
+                _cut(u, v);
+                // The tree without the old representative gets one.
+                _makeroot(u);
+                _mark(_sum[u] ? v : u);
+            } else {
+                u = rnd.next(1, n), v = rnd.next(1, n);
+                CPGEN_PROFILE_COUNT(draws, 2);
+                // When the trees are small, fall back to the root of the
+                // link-cut tree, which is a recently touched point.
+                for (int k = 0; connected_queries && !_connected(u, v); k++)
+                    v = k < 2 ? rnd.next(1, n) : _findroot(u),
+                    CPGEN_PROFILE_COUNT(rejects, 1);
+            }
+            ops.push_back({type, u, v});
+        }
+        q = ops.size() - 1;
         return *this;
     }
     /**
-     *  @brief  Generate an array with the i-th element is f(a_{i-1}).
-     *  @param  size the size of the array.
-     *  @param  GenerateFunction the GenerateFunction of the array.
-     *  @param  begin the begin value of the array.
-     *  @return The array itself.
-     *  @throw  It throws what the _Sequence throws.
+     *  @brief  Output the operations as `code u v`, one per line. NOTE that n
+     * and q will not be printed.
+     *  @return The stream itself.
      */
-    inline _Self generate_iterate_function(int size,
-                                           int (*IterateFunction)(int),
-                                           int begin = 1) {
-        init(size);
-        array.at(0) = begin;
-        for (int i = 1; i < size; i++)
-            array.at(i) = IterateFunction(array.at(i - 1));
+    inline _Self& print() {
+        _out.hold();
+        for (int i = 1; i <= q; i++)
+            _out.println(codes[int(ops[i].type)], ops[i].u, ops[i].v);
+        _out.release();
         return *this;
     }
-    inline _Self randomly_insert(int size, int num) {
-        while (size-- > 0)
-            array[rnd.next(1, n)] = num;
-        return *this;
+    /**
+     *  @brief  If \f$u\f$ and \f$v\f$ are in the same tree now.
+     */
+    inline bool connected(int u, int v) { return _connected(u, v); }
+
+   private:
+    std::vector<std::array<int, 2>> _ch;  ///< The children in the splay.
+    std::vector<int> _fa;    ///< The father in the splay, or the path-parent.
+    std::vector<char> _rev;  ///< The lazy reversal.
+    std::vector<int> _val;   ///< If the point is a representative.
+    std::vector<int> _sum;   ///< `_val` of the splay subtree and its virtual
+                             ///< subtrees.
+    std::vector<int> _virt;  ///< `_sum` of the virtual subtrees.
+    std::vector<int> _reps;  ///< The representatives.
+    std::vector<int> _pos;   ///< The index in `_reps`.
+    std::vector<int> _stack;  ///< Reused by `_splay()`.
+    inline void _mark(int x) {
+        _makeroot(x), _val[x] = 1, _pull(x);
+        _pos[x] = _reps.size(), _reps.push_back(x);
+    }
+    inline void _unmark(int x) {
+        _makeroot(x), _val[x] = 0, _pull(x);
+        _reps[_pos[x]] = _reps.back(), _pos[_reps.back()] = _pos[x];
+        _reps.pop_back();
+    }
+    inline bool _nroot(int x) {
+        return _ch[_fa[x]][0] == x || _ch[_fa[x]][1] == x;
+    }
+    inline void _pull(int x) {
+        _sum[x] = _sum[_ch[x][0]] + _sum[_ch[x][1]] + _val[x] + _virt[x];
+    }
+    inline void _push(int x) {
+        if (_rev[x]) {
+            std::swap(_ch[x][0], _ch[x][1]), _rev[x] = 0;
+            for (int c : _ch[x])
+                if (c)
+                    _rev[c] ^= 1;
+        }
+    }
+    inline void _rotate(int x) {
+        int y = _fa[x], z = _fa[y], k = _ch[y][1] == x, w = _ch[x][!k];
+        if (_nroot(y))
+            _ch[z][_ch[z][1] == y] = x;
+        _ch[x][!k] = y, _ch[y][k] = w;
+        if (w)
+            _fa[w] = y;
+        _fa[y] = x, _fa[x] = z;
+        _pull(y), _pull(x);
+    }
+    inline void _splay(int x) {
+        _stack.clear(), _stack.push_back(x);
+        for (int y = x; _nroot(y); y = _fa[y])
+            _stack.push_back(_fa[y]);
+        for (int i = _stack.size() - 1; i >= 0; i--)
+            _push(_stack[i]);
+        while (_nroot(x)) {
+            int y = _fa[x], z = _fa[y];
+            if (_nroot(y))
+                _rotate((_ch[y][0] == x) != (_ch[z][0] == y) ? x : y);
+            _rotate(x);
+        }
+    }
+    inline void _access(int x) {
+        for (int y = 0; x; y = x, x = _fa[x]) {
+            _splay(x);
+            _virt[x] += _sum[_ch[x][1]] - _sum[y];
+            _ch[x][1] = y, _pull(x);
+        }
+    }
+    inline void _makeroot(int x) { _access(x), _splay(x), _rev[x] ^= 1; }
+    inline int _findroot(int x) {
+        _access(x), _splay(x);
+        for (_push(x); _ch[x][0]; _push(x))
+            x = _ch[x][0];
+        _splay(x);
+        return x;
+    }
+    inline bool _connected(int u, int v) {
+        return u == v || _findroot(u) == _findroot(v);
+    }
+    inline void _link(int u, int v) {
+        _makeroot(u), _access(v), _splay(v);
+        _fa[u] = v, _virt[v] += _sum[u], _pull(v);
+    }
+    inline void _cut(int u, int v) {
+        _makeroot(u), _access(v), _splay(v);
+        _ch[v][0] = _fa[u] = 0, _pull(v);
     }
 };
 
-class Graph {
+/**
+ *  @brief  Class that used to generate a fully dynamic connectivity
+ * stream: `add` inserts a new edge, `remove` deletes an existing one, and
+ * `query` asks about two points. Every operation takes \f$O(1)\f$ expected
+ * time, and the lifetime of every edge is recorded for the offline
+ * problems (e.g. segment tree on time), see `offline()`.
+ * ```
+ * Graph graph;
+ * DynamicGraph dg;
+ * dg.init(graph.randomly_gen(n, m)).gen(q, {2, 1, 1}).print();
+ * ```
+ */
+class DynamicGraph {
    public:
-    using _Self = Graph;
-    int n;                ///< The count of points in the graph.
-    int m;                ///< The count of edges in the graph.
-    bool directed;        ///< Denoting if the **edges** are directed or not.
-    std::set<pii> edges;  ///< The container of edges.
-
-    Graph() {}
-    Graph(Tree tr, bool direction = 0) {
-        n = tr.n, m = n - 1;
-        if (direction) {
-            for (int i = 2; i <= n; i++)
-                edges.insert({i, tr.fa.at(i)});
-        } else {
-            for (int i = 2; i <= n; i++)
-                edges.insert({tr.fa.at(i), i});
-        }
-    }
+    using _Self = DynamicGraph;
     /**
-     *  @brief  Add a graph to the current graph.
-     *  @param  rhs the graph to be added.
-     *  @return The graph itself.
-     *  @throw  It throws what the _Sequence throws.
+     *  @brief  The edge \f$(u, v)\f$ exists from the `begin`-th operation,
+     * until right before the `end`-th one. The edges of `init()` begin at
+     * \f$0\f$, and the edges never removed end at \f$q+1\f$ in
+     * `offline()`.
      */
-    inline _Self add(Graph rhs) {
-        int offset = n;
-        n += rhs.n, m += rhs.m;
-        for (pii edge : rhs.edges)
-            edges.insert({offset + edge.first, offset + edge.second});
-        return *this;
-    }
-    inline Graph operator+(Graph rhs) {
-        Graph g = *this;
-        return g.add(rhs);
-    }
-    inline _Self operator+=(Graph rhs) { return add(rhs); }
+    struct Interval {
+        int u, v, begin, end;
+    };
+    int n = 0;                     ///< The count of points.
+    int q = 0;                     ///< The count of the operations.
+    std::vector<Operation> ops;    ///< The operations, 1-indexed.
+    std::vector<pii> edges;        ///< The edges of the graph now.
+    std::vector<Interval> timeline;  ///< The lifetime of the removed edges.
+    std::array<int, 3> codes{1, 2, 3};  ///< The printed code of each type.
     /**
-     *  @brief  init the whole graph with the size of `size`, and direct
-     * `directed_graph`.
-     *  @param  size how large this graph should be.
-     *  @param  directed_graph is this graph directed or not.
-     *  @return no return.
-     *  @throw  It throws what the std::set throws.
+     *  @brief  Start from \f$n\f$ isolated points.
+     *  @param  size the count of points.
+     *  @return The stream itself.
+     *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
      */
-    void init(int size, bool directed_graph) {
+    inline _Self& init(int size) {
         if (size < 1)
             throw GenException(
                 format("Invalid 'n' has been passed in `init`: %d", size));
-        n = size;
-        edges.clear();
-        directed = directed_graph;
+        n = size, q = 0;
+        ops.assign(1, {EdgeOp::query, 0, 0});
+        edges.clear(), _since.clear(), timeline.clear();
+        _keys.assign(16, _empty), _pos.assign(16, 0);
+        return *this;
     }
     /**
-     *  @brief  To check out if the edge exists or not.
-     *  @param  u, v the point number of the edge that is being checked.
-     *  @return if the edge exists or not.
-     *  @throw  It throws what the std::set throws.
+     *  @brief  Start from the edges of `g`, skipping the self-loops and
+     * the multiple edges.
+     *  @return The stream itself.
      */
-    inline bool exists(int u, int v) {
-        if (edges.count({u, v}))
-            return true;
-        if (!directed)
-            return edges.count({v, u});
+    inline _Self& init(const Graph& g) {
+        init(g.n);
+        for (auto [u, v] : g.edges)
+            if (u != v && !_find(_key(u, v)))
+                _insert(u, v, 0);
+        return *this;
     }
     /**
-     *  @brief  Generate a graph completely random.
-     *  @param  size how large this graph should be.
-     *  @param  edges_count the count of the edges.
-     *  @param  directed_graph is this graph directed or not.
-     *  @return no return.
-     *  @throw  It throws what the std::set throws.
+     *  @brief  Append `count` operations.
+     *  @param  count the count of the operations.
+     *  @param  weights the relative frequency of insertions, deletions and
+     * queries. When an insertion is impossible (the graph is complete), a
+     * deletion is made instead, and vice versa.
+     *  @return The stream itself.
+     *  @throw  out_of_range if the weights are all zero.
      */
-    inline _Self randomly_gen(int size,
-                              int edges_count,
-                              bool directed_graph = false) {
-        m = edges_count;
-        init(size, directed_graph);
-        for (int i = 1; i <= edges_count; i++) {
-            int u = rnd.next(1, size), v = rnd.next(1, size);
-            if (!exists(u, v))
-                edges.insert({u, v});
-            else
-                i--;
+    inline _Self& gen(int count, std::array<int, 3> weights = {1, 1, 1}) {
+        CPGEN_PROFILE_SCOPE("DynamicGraph::gen");
+        int total = weights[0] + weights[1] + weights[2];
+        ensure(n >= 1 && count >= 0 && total > 0);
+        ensure(weights[0] >= 0 && weights[1] >= 0 && weights[2] >= 0);
+        long long cap = 1ll * n * (n - 1) / 2;
+        ops.reserve(q + count + 1);
+        for (int i = 1; i <= count; i++) {
+            int t = rnd.next(total), id = ops.size(), u, v;
+            EdgeOp type = t < weights[0]              ? EdgeOp::add
+                          : t < weights[0] + weights[1] ? EdgeOp::remove
+                                                        : EdgeOp::query;
+            if (type == EdgeOp::add && (long long)edges.size() == cap)
+                type = cap ? EdgeOp::remove : EdgeOp::query;
+            if (type == EdgeOp::remove && edges.empty())
+                type = cap ? EdgeOp::add : EdgeOp::query;
+            if (type == EdgeOp::add) {
+                // The rejections are few unless the graph is nearly
+                // complete, which needs m close to n^2 / 2 anyway.
+                do
+                    u = rnd.next(1, n), v = rnd.next(1, n),
+                    CPGEN_PROFILE_COUNT(draws, 2);
+                while (u == v || _find(_key(u, v)));
+                _insert(u, v, id);
+            } else if (type == EdgeOp::remove) {
+                std::tie(u, v) = edges[rnd.next(int(edges.size()))];
+                _erase(u, v, id);
+            } else {
+                u = rnd.next(1, n), v = rnd.next(1, n);
+            }
+            ops.push_back({type, u, v});
         }
+        q = ops.size() - 1;
         return *this;
     }
     /**
-     *  @brief  Generate a DAG.
-     *  @param  size how large this graph should be.
-     *  @param  edges_count the count of the edges.
-     *  @param  directed_graph is this graph directed or not.
-     *  @return no return.
-     *  @throw  It throws what the std::set throws.
+     *  @brief  The lifetime of every edge, including the edges that are
+     * never removed, for the offline problems.
+     *  @return The intervals, in the order of removal.
      */
-    inline _Self DAG(int size, int edges_count, bool ensure_connected = true) {
-        m = edges_count;
-        std::vector<int> a(size + 1);
-        std::iota(a.begin(), a.end(), 0);
-        _rnd.shuffle(a);
-        if (ensure_connected) {
-            ensure(edges_count >= size - 1);
-            Tree tree;
-            tree.random_shaped_tree(size);
-            auto Sort = [](pii a) {
-                return a.first > a.second ? std::make_pair(a.second, a.first)
-                                          : a;
-            };
-            for (int i = 2; i <= size; i++)
-                edges.insert(Sort({a[tree.fa.at(i)], a[i]}));
-            edges_count -= (size - 1);
-        }
-        for (int i = 1; i <= edges_count; i++) {
-            int u = rnd.next(size) + 1, v = u + rnd.next(size - u) + 1;
-            if (u == v || exists(a[u], a[v]))
-                i--;
-            else
-                edges.insert({a[u], a[v]});
-        }
-        return *this;
+    inline std::vector<Interval> offline() const {
+        std::vector<Interval> res = timeline;
+        for (size_t i = 0; i < edges.size(); i++)
+            res.push_back({edges[i].first, edges[i].second, _since[i], q + 1});
+        return res;
     }
     /**
-     *  @brief  Generate a forest.
-     *  @param  size how large this graph should be.
-     *  @param  cnt the count of the trees.
-     *  @return no return.
-     *  @throw  It throws what the std::set throws.
+     *  @brief  Output `offline()` as `u v begin end`, one per line.
+     *  @return The stream itself.
      */
-
-    inline _Self forest(int size, int cnt = -1) {
-        cnt = ~cnt ? cnt : rnd.next(1, std::min(std::max(n / 1000, 10), size));
-        Tree tr;
-        tr.random_shaped_tree(size);
-        *this = tr;
-        Array<int> arr;
-        arr.permutation(size).shuffle();
-        for (int i = 1; i <= cnt; i++)
-            edges.erase({tr.fa.at(arr[i]), arr[i]});
+    inline _Self& print_offline() {
+        _out.hold();
+        for (const Interval& it : offline())
+            _out.println(it.u, it.v, it.begin, it.end);
+        _out.release();
         return *this;
     }
     /**
-     *  @brief  Generate a graph, on which spfa works so slow.
-     *  @param  size how large this graph should be.
-     *  @param  size how large this graph should be.
-     *  @param  edges_count the count of the edges.
-     *  @return no return.
-     *  @throw  It throws what the std::set throws.
+     *  @brief  Output the operations as `code u v`, one per line. NOTE that n
+     * and q will not be printed.
+     *  @return The stream itself.
      */
-    inline void hack_spfa(int size, int edges_count) {
-        int sz = sqrt(size);
-        m = edges_count;
-        for (int i = 1; i <= sz; i++) {
-            for (int j = 1; j <= sz; j++) {
-                if (i != 1 && edges_count)
-                    edges.insert({(i - 1) * sz + j, i * sz + j}), edges_count--;
-                if (j != 1 && edges_count)
-                    edges.insert({i * sz + j - 1, i * sz + j}), edges_count--;
+    inline _Self& print() {
+        _out.hold();
+        for (int i = 1; i <= q; i++)
+            _out.println(codes[int(ops[i].type)], ops[i].u, ops[i].v);
+        _out.release();
+        return *this;
+    }
+
+   private:
+    std::vector<int> _since;  ///< `_since[i]` is when `edges[i]` is added.
+    /// An open addressing table from the keys of `edges` to their indexes,
+    /// with backward shift deletion.
+    std::vector<unsigned long long> _keys;
+    std::vector<int> _pos;
+    static constexpr unsigned long long _empty = ~0ull;
+    static inline unsigned long long _key(int u, int v) {
+        if (u > v)
+            std::swap(u, v);
+        return (unsigned long long)(unsigned)u << 32 | (unsigned)v;
+    }
+    inline size_t _home(unsigned long long key) const {
+        return (key * 0x9e3779b97f4a7c15ull) >> 32 & (_keys.size() - 1);
+    }
+    inline size_t _slot(unsigned long long key) const {
+        size_t i = _home(key), mask = _keys.size() - 1;
+        while (_keys[i] != _empty && _keys[i] != key)
+            i = (i + 1) & mask;
+        return i;
+    }
+    inline bool _find(unsigned long long key) const {
+        return _keys[_slot(key)] != _empty;
+    }
+    inline void _insert(int u, int v, int time) {
+        if (2 * (edges.size() + 1) > _keys.size()) {
+            _keys.assign(2 * _keys.size(), _empty);
+            _pos.assign(_keys.size(), 0);
+            for (size_t i = 0; i < edges.size(); i++) {
+                size_t s = _slot(_key(edges[i].first, edges[i].second));
+                _keys[s] = _key(edges[i].first, edges[i].second), _pos[s] = i;
             }
         }
-        for (int i = 1; i <= edges_count; i++) {
-            int u = rnd.next(size) + 1, v = u + rnd.next(n - u + 1) + 1;
-            if (u == v || exists(u, v))
-                i--;
-            else
-                edges.insert({u, v});
+        size_t s = _slot(_key(u, v));
+        _keys[s] = _key(u, v), _pos[s] = edges.size();
+        edges.push_back({u, v}), _since.push_back(time);
+    }
+    inline void _erase(int u, int v, int time) {
+        size_t s = _slot(_key(u, v)), mask = _keys.size() - 1;
+        int i = _pos[s];
+        timeline.push_back({u, v, _since[i], time});
+        // Move the last edge into the hole.
+        edges[i] = edges.back(), _since[i] = _since.back();
+        _pos[_slot(_key(edges[i].first, edges[i].second))] = i;
+        edges.pop_back(), _since.pop_back();
+        _keys[s] = _empty;
+        for (size_t j = (s + 1) & mask; _keys[j] != _empty;
+             j = (j + 1) & mask) {
+            size_t h = _home(_keys[j]);
+            // Move `j` back to the hole unless its home is in (s, j].
+            if ((j > s && (h <= s || h > j)) || (j < s && h <= s && h > j)) {
+                _keys[s] = _keys[j], _pos[s] = _pos[j];
+                _keys[j] = _empty, s = j;
+            }
         }
     }
 };
@@ -846,13 +4357,16 @@ class String {
     std::string str;  ///< The container of the string.
 
     inline String operator+(String s) { return String{str + s.str}; }
-    inline String operator+=(String s) { return *this = String{str + s.str}; }
+    inline String& operator+=(const String& s) {
+        str += s.str;
+        return *this;
+    }
     /**
      *  @brief  Output the generated string to stdout. NOTE that n will not be
      * printed.
      *  @throw  out_of_range if @a size is an invalid node count, e.g. -1.
      */
-    inline void print() { println(str); }
+    inline void print() { _out.println(str); }
     /**
      *  @brief  return the reference of the size-th element in this string. NOTE
      * that this is 1-indexed.
@@ -943,14 +4457,123 @@ class String {
      *  @return The generated string.
      */
     inline std::string random_insert(int size, char rep) {
-        Array<int> array;
-        array.ascending_array(size, 0, str.length() - 1);
-        for (int i : array)
-            str[i] = rep;
+        while (size-- > 0)
+            str[rnd.next(0, int(str.length()) - 1)] = rep;
         return str;
     }
 };
 
+/**
+ *  @brief  The distributions of the sizes of the test cases, see
+ * `TestPack::split()`.
+ */
+enum class SizeDistribution {
+    one_giant,           ///< One case takes what the others leave.
+    all_equal,           ///< The sizes differ by at most \f$1\f$.
+    random_composition,  ///< Uniform among all the possible sizes.
+};
+
+/**
+ *  @brief  Class that used to generate multi-testcase input, whose sum of
+ * \f$n\f$ is bounded, e.g. \f$\sum n\le 2\cdot 10^5\f$:
+ * ```
+ * TestPack pack;
+ * Tree tree;
+ * pack.split(200000, 1000).run(tree, [](Tree& t, int n) {
+ *     _out.println(n);
+ *     t.random_shaped_tree(n).print(1);
+ * });
+ * ```
+ * The same object generates every case, so its containers are reused, and
+ * the scratch buffers of each case are taken back by `arena`. The output of
+ * all the cases is buffered by `_out` as a whole.
+ */
+class TestPack {
+   public:
+    using _Self = TestPack;
+    int T = 0;               ///< The count of the test cases.
+    std::vector<int> sizes;  ///< `sizes[i]` is the size of the i-th case.
+    Arena arena;             ///< The arena shared by the cases.
+    /**
+     *  @brief  Split `total` into the sizes of `cases` test cases, in
+     * \f$O(T\log T)\f$.
+     *  @param  total the sum of the sizes.
+     *  @param  cases the count of the test cases.
+     *  @param  distribution how the sizes are distributed.
+     *  @param  min_size the sub of the sizes.
+     *  @return The pack itself.
+     *  @throw  out_of_range if `total < cases * min_size`.
+     */
+    inline _Self& split(i64_ll total,
+                        int cases,
+                        SizeDistribution distribution =
+                            SizeDistribution::random_composition,
+                        int min_size = 1) {
+        ensure(cases >= 1 && min_size >= 0);
+        ensure(total >= 1ll * cases * min_size);
+        ensure(total - 1ll * (cases - 1) * min_size <= INT_MAX);
+        T = cases;
+        sizes.assign(T + 1, min_size), sizes[0] = 0;
+        i64_ll rest = total - 1ll * T * min_size;
+        if (distribution == SizeDistribution::one_giant) {
+            sizes[rnd.next(1, T)] += rest;
+        } else if (distribution == SizeDistribution::all_equal) {
+            for (int i = 1; i <= T; i++)
+                sizes[i] += rest / T + (i <= rest % T);
+        } else {
+            // Choose T - 1 bars among rest + T - 1 places by Floyd's
+            // algorithm, then the i-th size is the gap before the i-th bar.
+            ArenaScope scope(arena);
+            i64_ll places = rest + T - 1;
+            auto bars = _scratch<i64_ll>();
+            bars.reserve(T);
+            size_t mask = 1;
+            while (mask < 2u * T)
+                mask <<= 1;
+            auto table = _scratch<i64_ll>(mask--);
+            std::fill(table.begin(), table.end(), -1);
+            auto insert = [&](i64_ll x) {
+                size_t i = (x * 0x9e3779b97f4a7c15ull) >> 32 & mask;
+                for (; ~table[i]; i = (i + 1) & mask)
+                    if (table[i] == x)
+                        return false;
+                return table[i] = x, bars.push_back(x), true;
+            };
+            for (i64_ll j = places - (T - 1); j < places; j++)
+                if (!insert(rnd.next(0ll, j)))
+                    insert(j);
+            std::sort(bars.begin(), bars.end());
+            bars.push_back(places);
+            for (int i = 1; i <= T; i++)
+                sizes[i] += bars[i - 1] - (i > 1 ? bars[i - 2] + 1 : 0);
+        }
+        return *this;
+    }
+    /**
+     *  @brief  Generate the test cases. `T` is printed first, then
+     * `gen(obj, sizes[i])` is called for every case, which should print the
+     * case through `_out`.
+     *  @param  obj the object reused by the cases, e.g. a `Tree`.
+     *  @param  gen any callable that accepts `obj` and the size of the case.
+     *  @param  print_count if `T` should be printed.
+     *  @return The pack itself.
+     *  @throw  It throws what `gen` throws.
+     */
+    template <typename _Obj, typename _Func>
+    inline _Self& run(_Obj& obj, _Func gen, bool print_count = true) {
+        CPGEN_PROFILE_SCOPE("TestPack::run");
+        _out.hold();
+        if (print_count)
+            _out.println(T);
+        for (int i = 1; i <= T; i++) {
+            ArenaScope scope(arena);
+            gen(obj, sizes[i]);
+        }
+        _out.release();
+        return *this;
+    }
+};
+
 /**
  *  @brief  The struct that represent a point on a 2D plane.
  *  @param  PointType the value type of the Point.
@@ -1026,12 +4649,14 @@ class Geometry {
      *  @param  leftbottom, rightup the range of the points.
      */
     inline void randomize_points(int size, _Tp leftbottom, _Tp rightup) {
+        CPGEN_PROFILE_SCOPE("Geometry::randomize_points");
         init();
         for (int i = 1; i <= size; i++) {
             PointType x = rnd.next(leftbottom.x, rightup.x),
                       y = rnd.next(leftbottom.y, rightup.y);
+            CPGEN_PROFILE_COUNT(draws, 2);
             if (points.find({x, y}) != points.end())
-                i--;
+                i--, CPGEN_PROFILE_COUNT(rejects, 1);
             else
                 points.insert({x, y});
         }